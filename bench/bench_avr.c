@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file bench_avr.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Timing bench firmware for the barebone AVR target, run under simavr.
+ *
+ * The following firmware transmits a known frame through every transmission path
+ * of the AVR target, each followed by a reset, and traces the data pin (PB0) into a
+ * VCD file, which is then decoded by wsdecode.py. The frames are transmitted in the order
+ * of the `AVR_FRAMES` list of the bench Makefile.
+ *
+ * The trace is written through simavr's firmware sections (see avr_mcu_section.h), which
+ * also hold the MCU and clock to be simulated, and is stopped once the frames have been
+ * transmitted. Sleeping with interrupts disabled then terminates simavr.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+
+#include <ws2812.h>
+
+#include "avr_mcu_section.h"
+
+#ifndef BENCH_MCU
+#define BENCH_MCU "atmega328p"
+#endif
+
+#ifndef BENCH_VCD
+#define BENCH_VCD "bench_avr.vcd"
+#endif
+
+#define BENCH_LEDS 16                            ///< LEDs per frame, as expected by wsdecode.py
+#define BENCH_RST_US 200                        ///< Reset time, must exceed the frame split of wsdecode.py
+#define BENCH_PATTERN(k) (((k) * 37 + 11) & 0xFF) ///< Color byte k of the bench frame
+
+AVR_MCU(F_CPU, BENCH_MCU);
+AVR_MCU_VCD_FILE(BENCH_VCD, 1000);
+AVR_MCU_SIMAVR_COMMAND(&GPIOR0);
+
+const struct avr_mmcu_vcd_trace_t _bench_trace[] _MMCU_ = {
+        { AVR_MCU_VCD_SYMBOL("DIN"), .mask = _BV(PB0), .what = (void *) &PORTB, },
+};
+
+ws2812_rgb pxls[BENCH_LEDS];
+
+const ws2812_rgb pxls_P[BENCH_LEDS] PROGMEM = {
+#define P(i) { BENCH_PATTERN(i * 3), BENCH_PATTERN(i * 3 + 1), BENCH_PATTERN(i * 3 + 2) }
+        P(0), P(1), P(2), P(3), P(4), P(5), P(6), P(7),
+        P(8), P(9), P(10), P(11), P(12), P(13), P(14), P(15)
+#undef P
+};
+
+ws2812_rgb gen(size_t idx, void *ctx)
+{
+        return ((ws2812_rgb *) ctx)[idx];
+}
+
+int main()
+{
+        uint8_t pins[] = {PB0};
+        uint8_t indices[(BENCH_LEDS * 2 + 7) / 8];
+        ws2812_rgb *lanes[8] = {pxls};
+        ws2812_run runs[2];
+        ws2812_cfg cfg;
+        ws2812 dev;
+
+        for (uint16_t k = 0; k < BENCH_LEDS * 3; k++)
+                ((uint8_t *) pxls)[k] = BENCH_PATTERN(k);
+
+        // Index i % 4 into a palette of the first four pixels
+        for (uint8_t i = 0; i < sizeof(indices); i++)
+                indices[i] = 0x1B;
+
+        runs[0].color = pxls[0];
+        runs[0].n_pxls = BENCH_LEDS / 2;
+        runs[1].color = pxls[1];
+        runs[1].n_pxls = BENCH_LEDS - BENCH_LEDS / 2;
+
+        cfg.port = &PORTB;
+        cfg.ddr = &DDRB;
+        cfg.pins = pins;
+        cfg.n_dev = sizeof(pins);
+        cfg.rst_time_us = BENCH_RST_US;
+        cfg.order = rgb;
+
+        if (ws2812_config(&dev, &cfg) != 0)
+                goto done;
+
+        GPIOR0 = SIMAVR_CMD_VCD_START_TRACE;
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx(&dev, pxls, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_P(&dev, pxls_P, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_fill(&dev, pxls[0], BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_rle(&dev, runs, 2);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_raw(&dev, (const uint8_t *) pxls, sizeof(pxls));
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_gen(&dev, gen, pxls, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_indexed(&dev, indices, 2, pxls, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_prep_tx(&dev);
+        ws2812_tx_parallel(&dev, lanes, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        ws2812_set_brightness(&dev, 127);
+        ws2812_prep_tx(&dev);
+        ws2812_tx(&dev, pxls, BENCH_LEDS);
+        ws2812_close_tx(&dev);
+
+        GPIOR0 = SIMAVR_CMD_VCD_STOP_TRACE;
+
+done:
+        cli();
+        sleep_enable();
+        sleep_cpu();
+
+        return 0;
+}
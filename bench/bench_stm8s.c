@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+  * @file bench_stm8s.c
+  * @author Patrick Pedersen
+  * @date 2026-10-14
+  * @brief Timing bench firmware for the STM8S target, run under ucsim (sstm8).
+  *
+  * The following firmware transmits a known frame through every transmission path
+  * of the STM8S target, each followed by a reset, on the data pin PD4, whose output
+  * data register is traced into a VCD file by ucsim and then decoded by wsdecode.py.
+  * The frames are transmitted in the order of the `STM8S_FRAMES` list of the bench Makefile.
+  *
+  * The clock tree is left untouched, as ucsim times the instructions at the clock passed
+  * through its -X option. The simulation is stopped by the bench Makefile once bench_done()
+  * is reached.
+  */
+
+#include <stm8s.h>
+
+#include <ws2812.h>
+
+#define BENCH_LEDS 16					///< LEDs per frame, as expected by wsdecode.py
+#define BENCH_RST_US 200				///< Reset time, must exceed the frame split of wsdecode.py
+#define BENCH_PATTERN(k) (((k) * 37 + 11) & 0xFF)	///< Color byte k of the bench frame
+
+GPIO_Pin_TypeDef pins[] = {GPIO_PIN_4};
+ws2812_rgb pxls[BENCH_LEDS];
+uint8_t indices[(BENCH_LEDS * 2 + 7) / 8];
+ws2812_rgb *lanes[8];
+ws2812_run runs[2];
+ws2812 dev;
+
+ws2812_rgb gen(size_t idx, void *ctx)
+{
+	return ((ws2812_rgb *) ctx)[idx];
+}
+
+void bench_done()
+{
+	while (1);
+}
+
+void main()
+{
+	ws2812_cfg cfg;
+	uint16_t k;
+
+	for (k = 0; k < BENCH_LEDS * 3; k++)
+		((uint8_t *) pxls)[k] = BENCH_PATTERN(k);
+
+	// Index i % 4 into a palette of the first four pixels
+	for (k = 0; k < sizeof(indices); k++)
+		indices[k] = 0x1B;
+
+	lanes[4] = pxls;
+
+	runs[0].color = pxls[0];
+	runs[0].n_pxls = BENCH_LEDS / 2;
+	runs[1].color = pxls[1];
+	runs[1].n_pxls = BENCH_LEDS - BENCH_LEDS / 2;
+
+	cfg.pins		= pins;
+	cfg.rst_time_us		= BENCH_RST_US;
+	cfg.order		= rgb;
+	cfg.n_dev		= sizeof(pins);
+	cfg.port_baseaddr	= GPIOD_BaseAddress;
+
+	if (ws2812_config(&dev, &cfg) != 0)
+		bench_done();
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx(&dev, pxls, BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_fill(&dev, pxls[0], BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_rle(&dev, runs, 2);
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_raw(&dev, (const uint8_t *) pxls, sizeof(pxls));
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_gen(&dev, gen, pxls, BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_indexed(&dev, indices, 2, pxls, BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	ws2812_prep_tx(&dev);
+	ws2812_tx_parallel(&dev, lanes, BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	ws2812_set_brightness(&dev, 127);
+	ws2812_prep_tx(&dev);
+	ws2812_tx(&dev, pxls, BENCH_LEDS);
+	ws2812_close_tx(&dev);
+
+	bench_done();
+}
+
+// See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
+#ifdef USE_FULL_ASSERT
+void assert_failed(uint8_t* file, uint32_t line)
+{
+	while (TRUE)
+	{
+	}
+}
+#endif
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026  Patrick Pedersen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Decodes the WS2812 data pin waveform of a VCD trace.
+
+The trace is split into frames at every low phase longer than --split-us. Every high
+pulse is classified as a "0" or a "1", and the resulting bytes are checked against
+the frames transmitted by the bench firmware (see bench_avr.c and bench_stm8s.c).
+For every frame, the T0H, T1H and bit period histograms, the gaps between bytes and
+pixels, and the frame time are reported. The exit status is non-zero if a frame has
+not been decoded as expected, or if its timing violates the selected profile.
+"""
+
+import argparse
+import re
+import sys
+from collections import Counter
+
+# Timing limits in ns: longest "0", shortest "1", shortest bit period and longest low phase
+# within a frame before the WS2812 may latch (see WS2812_TIMING_* in ws2812_common.h)
+PROFILES = {
+        "default": dict(t0h_max=550, t1h_min=625, period_min=1150, latch=5000),
+        "ws2812":  dict(t0h_max=500, t1h_min=550, period_min=1050, latch=5000),
+        "ws2812b": dict(t0h_max=380, t1h_min=580, period_min=950,  latch=5000),
+        "sk6812":  dict(t0h_max=450, t1h_min=450, period_min=950,  latch=5000),
+        "ws2813":  dict(t0h_max=380, t1h_min=580, period_min=950,  latch=5000),
+}
+
+TIMESCALE = {"s": 1e9, "ms": 1e6, "us": 1e3, "ns": 1.0, "ps": 1e-3, "fs": 1e-6}
+
+
+def pattern(n_bytes):
+        """Color bytes transmitted by the bench firmware, see BENCH_PATTERN()."""
+        return [(k * 37 + 11) & 0xFF for k in range(n_bytes)]
+
+
+def expected(label, n_leds):
+        """Bytes the bench firmware transmits for the frame of the given label."""
+        pat = pattern(n_leds * 3)
+        pxl = lambda i: pat[i * 3:i * 3 + 3]
+
+        if label in ("tx", "tx_P", "tx_raw", "tx_gen", "tx_parallel", "tx_encoded"):
+                return pat
+        if label == "tx_fill":
+                return pxl(0) * n_leds
+        if label == "tx_rle":
+                return pxl(0) * (n_leds // 2) + pxl(1) * (n_leds - n_leds // 2)
+        if label == "tx_indexed":
+                return sum((pxl(i % 4) for i in range(n_leds)), [])
+        if label == "tx_scaled":
+                return [(c * 128) >> 8 for c in pat]
+        return None
+
+
+def parse_vcd(path, signal):
+        """Returns the (time in ns, level) changes of the selected 1 bit signal."""
+        scale = 1.0
+        ids = {}
+        changes = []
+        t = 0.0
+        sel = None
+
+        with open(path) as f:
+                text = f.read()
+
+        header, _, body = text.partition("$enddefinitions")
+
+        m = re.search(r"\$timescale\s+(\d+)\s*(\w+)\s+\$end", header)
+        if m:
+                scale = int(m.group(1)) * TIMESCALE[m.group(2)]
+
+        for m in re.finditer(r"\$var\s+\S+\s+(\d+)\s+(\S+)\s+(\S+)(?:\s+\[[^\]]*\])?\s+\$end", header):
+                ids[m.group(3)] = m.group(2)
+
+        if not ids:
+                sys.exit("%s: no signals found" % path)
+
+        if signal is None:
+                sel = next(iter(ids.values()))
+        elif signal in ids:
+                sel = ids[signal]
+        else:
+                sys.exit("%s: no signal named %s (found: %s)" % (path, signal, ", ".join(ids)))
+
+        for tok in re.finditer(r"#(\d+)|([01xXzZ])(\S+)|[bB]([01xXzZ]+)\s+(\S+)", body.split("$end", 1)[-1]):
+                if tok.group(1) is not None:
+                        t = int(tok.group(1)) * scale
+                elif tok.group(3) == sel:
+                        changes.append((t, 1 if tok.group(2) == "1" else 0))
+                elif tok.group(5) == sel:
+                        changes.append((t, 1 if "1" in tok.group(4) else 0))
+
+        # Drop rewrites of the same level (ex. port writes that leave the pin unchanged)
+        edges = []
+        for t, v in changes:
+                if edges and edges[-1][0] == t:
+                        edges[-1] = (t, v)
+                if not edges or edges[-1][1] != v:
+                        edges.append((t, v))
+
+        return edges
+
+
+def split_frames(edges, split_ns):
+        """Returns the (rise, fall) times of the high pulses of every frame."""
+        frames = []
+        pulses = []
+        rise = None
+
+        for t, v in edges:
+                if v == 1:
+                        if pulses and t - pulses[-1][1] > split_ns:
+                                frames.append(pulses)
+                                pulses = []
+                        rise = t
+                elif rise is not None:
+                        pulses.append((rise, t))
+                        rise = None
+
+        if pulses:
+                frames.append(pulses)
+
+        return frames
+
+
+def threshold(highs, default):
+        """Splits the high pulses at the largest gap between their lengths, ex. between T0H and T1H."""
+        s = sorted(set(round(h) for h in highs))
+        gaps = [(b - a, (a + b) / 2) for a, b in zip(s, s[1:])]
+
+        if gaps:
+                gap, mid = max(gaps)
+                if gap > 100:
+                        return mid
+
+        return default
+
+
+def histogram(values, res):
+        """Formats a histogram of the values, bucketed to res ns."""
+        c = Counter(int(round(v / res) * res) for v in values)
+        return ", ".join("%dns x%d" % (k, c[k]) for k in sorted(c))
+
+
+def stats(values):
+        if not values:
+                return "-"
+        return "min %.0fns / mean %.0fns / max %.0fns" % (min(values), sum(values) / len(values), max(values))
+
+
+def report(label, pulses, args, prof, res):
+        ok = True
+        highs = [f - r for r, f in pulses]
+        thr = threshold(highs, (prof["t0h_max"] + prof["t1h_min"]) / 2)
+        bits = [1 if h > thr else 0 for h in highs]
+        n_bytes = len(bits) // 8
+        data = [int("".join(map(str, bits[i * 8:i * 8 + 8])), 2) for i in range(n_bytes)]
+
+        t0h = [h for h, b in zip(highs, bits) if b == 0]
+        t1h = [h for h, b in zip(highs, bits) if b == 1]
+        period = []     # Rising edge to rising edge within a byte
+        low_bit = []    # Low phase between two bits of a byte
+        low_byte = []   # Low phase between two bytes of a pixel
+        low_pxl = []    # Low phase between two pixels
+
+        for i in range(len(pulses) - 1):
+                low = pulses[i + 1][0] - pulses[i][1]
+                if i % 8 != 7:
+                        period.append(pulses[i + 1][0] - pulses[i][0])
+                        low_bit.append(low)
+                elif i % 24 != 23:
+                        low_byte.append(low)
+                else:
+                        low_pxl.append(low)
+
+        frame_ns = pulses[-1][1] - pulses[0][0]
+
+        print("[%s] %d bits, %d bytes, frame %.1fus (%.2fus per LED)" %
+              (label, len(bits), n_bytes, frame_ns / 1000, frame_ns / 1000 / max(n_bytes / 3, 1)))
+        print("  T0H:        %s" % histogram(t0h, res))
+        print("  T1H:        %s" % histogram(t1h, res))
+        print("  period:     %s" % histogram(period, res))
+        print("  bit low:    %s" % stats(low_bit))
+        print("  byte gap:   %s" % stats(low_byte))
+        print("  pixel gap:  %s" % stats(low_pxl))
+
+        exp = expected(label, args.leds)
+        if len(bits) % 8:
+                print("  ERROR: %d trailing bits" % (len(bits) % 8))
+                ok = False
+        if exp is not None and data != exp:
+                bad = next((i for i, (a, b) in enumerate(zip(data, exp)) if a != b), min(len(data), len(exp)))
+                print("  ERROR: byte %d differs (%d bytes decoded, %d expected)" % (bad, len(data), len(exp)))
+                ok = False
+        if t0h and max(t0h) > prof["t0h_max"]:
+                print("  ERROR: T0H of %.0fns exceeds %dns" % (max(t0h), prof["t0h_max"]))
+                ok = False
+        if t1h and min(t1h) < prof["t1h_min"]:
+                print("  ERROR: T1H of %.0fns is below %dns" % (min(t1h), prof["t1h_min"]))
+                ok = False
+        if period and min(period) < prof["period_min"]:
+                print("  ERROR: bit period of %.0fns is below %dns" % (min(period), prof["period_min"]))
+                ok = False
+
+        lows = low_bit + low_byte + low_pxl
+        if lows and max(lows) > prof["latch"]:
+                print("  WARNING: low phase of %.1fus risks a latch" % (max(lows) / 1000))
+
+        return ok
+
+
+def main():
+        p = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+        p.add_argument("vcd", help="VCD trace of the data pin")
+        p.add_argument("--signal", help="Name of the data pin signal in the trace (default: first signal)")
+        p.add_argument("--frames", default="", help="Comma separated labels of the transmitted frames, in order")
+        p.add_argument("--leds", type=int, default=16, help="Number of LEDs per frame")
+        p.add_argument("--fcpu", type=int, help="CPU clock in Hz, buckets the histograms to one cycle")
+        p.add_argument("--profile", choices=PROFILES, default="default", help="Timing profile to check against")
+        p.add_argument("--split-us", type=float, default=40, help="Low phases longer than this separate frames")
+        args = p.parse_args()
+
+        prof = PROFILES[args.profile]
+        res = 1e9 / args.fcpu if args.fcpu else 10
+        labels = [l for l in args.frames.split(",") if l]
+        frames = split_frames(parse_vcd(args.vcd, args.signal), args.split_us * 1000)
+        ok = True
+
+        if labels and len(frames) != len(labels):
+                print("ERROR: %d frames decoded, %d expected" % (len(frames), len(labels)))
+                ok = False
+
+        for i, pulses in enumerate(frames):
+                ok &= report(labels[i] if i < len(labels) else "frame %d" % i, pulses, args, prof, res)
+
+        sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+        main()
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+/**
+ * @file blink_array.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ * 
+ * @brief Blinks one or more WS2812 devices using a RGB array and a USART in Master SPI mode.
+ * 
+ * The following example showcases how the Tiny-WS2812 library can
+ * be used on AVR platforms to blink an entire WS2812 device in white,
+ * where the data is shifted out by a USART in Master SPI mode on its TxD pin
+ * (ex. PD1 on the ATmega328P). Unlike the barebone AVR target, interrupts remain
+ * enabled throughout the transmission.
+ *
+ * @note Please ensure that the WS2812_TARGET_PLATFORM_AVR_USART macro
+ * is defined during compilation. This can either be done by specifying
+ * -DWS2812_TARGET_PLATFORM_AVR_USART in the build flags, or by uncommenting
+ * the define WS2812_TARGET_PLATFORM_AVR_USART directive below.
+ */
+
+// #define WS2812_TARGET_PLATFORM_AVR_USART
+
+#include <avr/io.h>
+#include <util/delay.h>
+
+#include <ws2812.h>
+
+// Parameters - ALTER THESE TO CORRESPOND WITH YOUR OWN SETUP!
+#define N_LEDS 8                ///< Number of LEDs on your WS2812 device(s)
+#define USART UCSR0A            ///< First register of the USART used to communicate with the WS2812 device(s)
+#define XCK_DDR DDRD            ///< Data direction register of the USART's XCK pin
+#define XCK_PIN PD4             ///< XCK pin of the USART
+#define RESET_TIME 50           ///< Reset time in microseconds (50us recommended by datasheet)
+#define COLOR_ORDER grb         ///< Color order of your WS2812 LEDs (Typically grb or rgb)
+
+/**
+ * Blinks one or more WS2812 device(s)
+ */
+int main()
+{
+        ws2812_rgb leds[N_LEDS];    // RGB array which represents the LEDs
+        ws2812_cfg cfg;             // Device configurationn
+        ws2812 ws2812_dev;          // Device struct
+
+        // Configure the WS2812 device struct
+        cfg.usart = &USART;
+        cfg.xck_ddr = &XCK_DDR;
+        cfg.xck_pin = XCK_PIN;
+        cfg.rst_time_us = RESET_TIME;
+        cfg.order = COLOR_ORDER;
+        
+        if (ws2812_config(&ws2812_dev, &cfg) != 0) {
+                // HANDLE ERROR...
+                void;
+        };
+
+        // Blink device
+        while (1) {
+                // Program all LEDs to white
+                for (unsigned int i = 0; i < N_LEDS; i++) {
+                        leds[i].r = 255;
+                        leds[i].g = 255;
+                        leds[i].b = 255;              
+                }
+
+                ws2812_prep_tx(&ws2812_dev);          // Prepare to transmit data
+                ws2812_tx(&ws2812_dev, leds, N_LEDS); // Transmit array of rgb values to the device
+                ws2812_close_tx(&ws2812_dev);         // Close transmission
+
+                // Wait 500ms
+                _delay_ms(500);
+
+                // Program all LEDs to black (off)
+                for (unsigned int i = 0; i < N_LEDS; i++) {
+                        leds[i].r = 0;
+                        leds[i].g = 0;
+                        leds[i].b = 0;
+                }
+
+                ws2812_prep_tx(&ws2812_dev);           // Prepare to transmit data
+                ws2812_tx(&ws2812_dev, leds, N_LEDS);  // Transmit array of rgb values to the device
+                ws2812_close_tx(&ws2812_dev);          // Close transmission
+
+                // Wait 500ms
+                _delay_ms(500);
+        }
+
+        return 0;
+}
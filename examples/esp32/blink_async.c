@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+/**
+  * @file blink_async.c
+  * @author Patrick Pedersen
+  * @date 2026-10-14
+  * @brief Blinks two WS2812 strips in parallel using the RMT peripheral. 
+  * 
+  * The following example showcases how the Tiny-WS2812 library can
+  * be used on ESP32 platforms (ESP-IDF) to blink two WS2812 strips in
+  * opposite colors, where each strip is driven by its own RMT channel.
+  * Both frames are transmitted in the background through ws2812_tx_async(),
+  * thus both strips are programmed at the same time.
+  * 
+  * @note Please ensure that the WS2812_TARGET_PLATFORM_ESP32 macro
+  * is defined during compilation. This can either be done by specifying
+  * -DWS2812_TARGET_PLATFORM_ESP32 in the build flags, or by uncommenting
+  * the define WS2812_TARGET_PLATFORM_ESP32 directive below.
+  */
+
+// #define WS2812_TARGET_PLATFORM_ESP32
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <ws2812.h>
+
+#define N_LEDS 8                        ///< Number of LEDs per strip
+#define RESET_TIME 50                   ///< Reset time in µs
+#define COLOR_ORDER grb                 ///< Color order of the strips
+
+#define STRIP_A_PIN 18                  ///< GPIO of the first strip
+#define STRIP_B_PIN 19                  ///< GPIO of the second strip
+
+#define DELAY_MS 500
+
+ws2812_rgb leds_a[N_LEDS];
+ws2812_rgb leds_b[N_LEDS];
+ws2812 strip_a;
+ws2812 strip_b;
+
+void app_main()
+{
+        uint8_t pin_a = STRIP_A_PIN;
+        uint8_t pin_b = STRIP_B_PIN;
+
+        // Initialize WS2812 device structs, one per RMT channel
+
+        ws2812_cfg cfg;
+
+        cfg.rst_time_us = RESET_TIME;
+        cfg.order       = COLOR_ORDER;
+        cfg.n_dev       = 1;
+
+        cfg.channel     = RMT_CHANNEL_0;
+        cfg.pins        = &pin_a;
+        ws2812_config(&strip_a, &cfg);
+
+        cfg.channel     = RMT_CHANNEL_1;
+        cfg.pins        = &pin_b;
+        ws2812_config(&strip_b, &cfg);
+
+        // Blink strips
+
+        while(1) {
+                uint8_t c = leds_a[0].r ? 0 : 255;
+
+                // Fill strip arrays with red/blue or blue/red
+                for (unsigned int i = 0; i < N_LEDS; i++) {
+                        leds_a[i].r = c;
+                        leds_a[i].g = 0;
+                        leds_a[i].b = 255 - c;
+                        leds_b[i].r = 255 - c;
+                        leds_b[i].g = 0;
+                        leds_b[i].b = c;
+                }
+
+                // Write to both strips at the same time
+                ws2812_prep_tx(&strip_a);
+                ws2812_prep_tx(&strip_b);
+                ws2812_tx_async(&strip_a, leds_a, N_LEDS);
+                ws2812_tx_async(&strip_b, leds_b, N_LEDS);
+
+                // Waits for the transmissions to finish
+                ws2812_close_tx(&strip_a);
+                ws2812_close_tx(&strip_b);
+
+                vTaskDelay(DELAY_MS / portTICK_PERIOD_MS);
+        }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+/**
+  * @file blink_parallel.c
+  * @author Patrick Pedersen
+  * @date 2026-10-14
+  * @brief Blinks a WS2812 strip in the background and four WS2812 strips in parallel using the PIO. 
+  * 
+  * The following example showcases how the Tiny-WS2812 library can
+  * be used on RP2040 platforms (Pico SDK) to drive WS2812 strips through
+  * the PIO. The first strip is driven by its own state machine, and is fed
+  * by DMA through ws2812_tx_async() while the CPU keeps running. The other
+  * four strips share a state machine, and are programmed with their own
+  * colors at the same time through ws2812_tx_parallel().
+  * 
+  * @note Please ensure that the WS2812_TARGET_PLATFORM_RP2040 macro
+  * is defined during compilation. This can either be done by specifying
+  * -DWS2812_TARGET_PLATFORM_RP2040 in the build flags, or by uncommenting
+  * the define WS2812_TARGET_PLATFORM_RP2040 directive below.
+  */
+
+// #define WS2812_TARGET_PLATFORM_RP2040
+
+#include <pico/stdlib.h>
+
+#include <ws2812.h>
+
+#define N_LEDS 8                        ///< Number of LEDs per strip
+#define RESET_TIME 50                   ///< Reset time in µs
+#define COLOR_ORDER grb                 ///< Color order of the strips
+
+#define ASYNC_PIN 16                    ///< GPIO of the background strip
+#define LANES_PIN 2                     ///< Lowest GPIO of the parallel strips (GPIO 2-5)
+#define N_LANES 4                       ///< Number of parallel strips
+
+#define DELAY_MS 500
+
+ws2812_rgb leds[N_LEDS];
+ws2812_rgb lane_leds[N_LANES][N_LEDS];
+uint8_t staging[sizeof(leds)];          ///< Holds the frame in GRB order for the DMA
+ws2812 async_dev;
+ws2812 lanes_dev;
+
+int main()
+{
+        uint8_t async_pin = ASYNC_PIN;
+        uint8_t lane_pins[N_LANES];
+        ws2812_rgb *lanes[8] = { NULL };
+
+        for (uint8_t l = 0; l < N_LANES; l++) {
+                lane_pins[l] = LANES_PIN + l;
+                lanes[l] = lane_leds[l];
+        }
+
+        // Initialize WS2812 device structs
+
+        ws2812_cfg cfg;
+
+        cfg.pio         = pio0;
+        cfg.rst_time_us = RESET_TIME;
+        cfg.order       = COLOR_ORDER;
+
+        cfg.pins        = &async_pin;
+        cfg.n_dev       = 1;
+        cfg.buf         = staging;
+        cfg.buf_size    = sizeof(staging);
+        ws2812_config(&async_dev, &cfg);
+
+        cfg.pins        = lane_pins;
+        cfg.n_dev       = N_LANES;
+        cfg.buf         = NULL;
+        cfg.buf_size    = 0;
+        ws2812_config(&lanes_dev, &cfg);
+
+        // Blink strips
+
+        while(1) {
+                uint8_t c = leds[0].r ? 0 : 255;
+
+                // Fill the background strip with red or black
+                // and every parallel strip with a different shade of blue
+                for (unsigned int i = 0; i < N_LEDS; i++) {
+                        leds[i].r = c;
+                        leds[i].g = 0;
+                        leds[i].b = 0;
+
+                        for (uint8_t l = 0; l < N_LANES; l++) {
+                                lane_leds[l][i].r = 0;
+                                lane_leds[l][i].g = 0;
+                                lane_leds[l][i].b = c >> l;
+                        }
+                }
+
+                // Write to the background strip, then to the parallel strips while it is being
+                // shifted out
+                ws2812_prep_tx(&async_dev);
+                ws2812_tx_async(&async_dev, leds, N_LEDS);
+
+                ws2812_prep_tx(&lanes_dev);
+                ws2812_tx_parallel(&lanes_dev, lanes, N_LEDS);
+                ws2812_close_tx(&lanes_dev);
+
+                // Waits for the background transmission to finish, if it hasn't already
+                ws2812_close_tx(&async_dev);
+
+                sleep_ms(DELAY_MS);
+        }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+/**
+  * @file blink_async.c
+  * @author Patrick Pedersen
+  * @date 2026-10-14
+  * @brief Blinks one or more WS2812 devices in the background using the SPI peripheral. 
+  * 
+  * The following example showcases how the Tiny-WS2812 library can
+  * be used on STM8S platforms to blink an entire WS2812 device in red,
+  * where the data is shifted out by the SPI peripheral on its MOSI pin (PC6).
+  * The frame is transmitted in the background through ws2812_tx_async(), while
+  * the main loop keeps running, and is fed by the SPI interrupt handler below.
+  * 
+  * @note Please ensure that the WS2812_TARGET_PLATFORM_STM8S_SPI macro
+  * is defined during compilation. This can either be done by specifying
+  * -DWS2812_TARGET_PLATFORM_STM8S_SPI in the build flags, or by uncommenting
+  * the define WS2812_TARGET_PLATFORM_STM8S_SPI directive below.
+  */
+
+// #define WS2812_TARGET_PLATFORM_STM8S_SPI
+
+#include <stm8s.h>
+
+#include <ws2812.h>
+
+#define N_LEDS 8				///< Number of LEDs in the strip
+#define RESET_TIME 30				///< Reset time in µs
+#define COLOR_ORDER grb				///< Color order of the strip
+
+#define WAIT_LOOPS 1000000
+
+ws2812_rgb leds[N_LEDS]; 
+ws2812 ws2812_dev;
+
+// Feeds the background transmission, must be visible to the file holding main() on SDCC
+INTERRUPT_HANDLER(SPI_IRQHandler, 10)
+{
+	ws2812_spi_isr();
+}
+
+void init_16mhz_clk()
+{
+	CLK_DeInit();
+	CLK_HSICmd(ENABLE);
+	CLK_HSECmd(DISABLE);
+	CLK_LSICmd(DISABLE);
+	CLK_SYSCLKConfig(CLK_PRESCALER_CPUDIV1);
+	CLK_SYSCLKConfig(CLK_PRESCALER_HSIDIV1);
+	CLK_ClockSwitchConfig(CLK_SWITCHMODE_AUTO, CLK_SOURCE_HSI, DISABLE, CLK_CURRENTCLOCKSTATE_DISABLE);
+}
+
+void main()
+{
+	// Initialize clock to run at 16Mhz
+	init_16mhz_clk();
+
+	// Initialize WS2812 device struct
+
+	ws2812_cfg cfg;
+
+	cfg.rst_time_us 		= RESET_TIME;
+	cfg.order 			= COLOR_ORDER;
+
+	ws2812_config(&ws2812_dev, &cfg);
+
+	enableInterrupts();
+	
+	// Blink strip
+
+	while(1) {
+		uint8_t c = leds[0].r ? 0 : 255;
+
+		// Fill strip array with red or black
+		for (unsigned int i = 0; i < N_LEDS; i++) {
+			leds[i].r = c;
+			leds[i].g = 0;
+			leds[i].b = 0;              
+		}
+
+		// Write to strip in the background
+		ws2812_prep_tx(&ws2812_dev);
+		ws2812_tx_async(&ws2812_dev, leds, N_LEDS);
+
+		// Keep doing other work while the frame is being shifted out
+		for (unsigned long i = 0; i < WAIT_LOOPS; i++) {
+			__asm__("nop");
+		}
+
+		// Waits for the transmission to finish, if it hasn't already
+		ws2812_close_tx(&ws2812_dev);
+	}
+}
+
+// See: https://community.st.com/s/question/0D50X00009XkhigSAB/what-is-the-purpose-of-define-usefullassert
+#ifdef USE_FULL_ASSERT
+void assert_failed(uint8_t* file, uint32_t line)
+{ 
+	while (TRUE)
+	{
+	}
+}
+#endif
@@ -30,6 +30,9 @@
  * 
  * The following platforms and frameworks are currently supported:
  *      - Barebone AVR
+ *      - Barebone AVR, driven by a USART in Master SPI mode
+ *      - ESP32, driven by the RMT peripheral (ESP-IDF or Arduino ESP32 core)
+ *      - RP2040, driven by the PIO (Pico SDK)
  *      - The Arduino Framework (Currently only AVR based (eg. Uno, Leonardo, Micro...))
  * 
  * It has been developed out of the necessity to have an extremely light 
@@ -70,6 +73,14 @@
 #include "ws2812_avr.h"
 #endif
 
+#ifdef WS2812_TARGET_PLATFORM_AVR_USART
+#ifdef _WS2812_TARGET_PLATFORM_DEFINED
+#error "Multiple target platforms defined!"
+#endif
+#define _WS2812_TARGET_PLATFORM_DEFINED
+#include "ws2812_avr_usart.h"
+#endif
+
 #ifdef WS2812_TARGET_PLATFORM_STM8S
 #ifdef _WS2812_TARGET_PLATFORM_DEFINED
 #error "Multiple target platforms defined!"
@@ -78,6 +89,30 @@
 #include "ws2812_stm8s.h"
 #endif
 
+#ifdef WS2812_TARGET_PLATFORM_STM8S_SPI
+#ifdef _WS2812_TARGET_PLATFORM_DEFINED
+#error "Multiple target platforms defined!"
+#endif
+#define _WS2812_TARGET_PLATFORM_DEFINED
+#include "ws2812_stm8s_spi.h"
+#endif
+
+#ifdef WS2812_TARGET_PLATFORM_ESP32
+#ifdef _WS2812_TARGET_PLATFORM_DEFINED
+#error "Multiple target platforms defined!"
+#endif
+#define _WS2812_TARGET_PLATFORM_DEFINED
+#include "ws2812_esp32.h"
+#endif
+
+#ifdef WS2812_TARGET_PLATFORM_RP2040
+#ifdef _WS2812_TARGET_PLATFORM_DEFINED
+#error "Multiple target platforms defined!"
+#endif
+#define _WS2812_TARGET_PLATFORM_DEFINED
+#include "ws2812_rp2040.h"
+#endif
+
 #ifndef _WS2812_TARGET_PLATFORM_DEFINED
 #error "No target platform defined!"
 #endif
@@ -98,6 +133,29 @@
  */
 void _ws2812_get_rgbmap(uint8_t (*rgbmap)[3], ws2812_order order);
 
+/**
+ * @brief Applies the LUT and brightness of a @ref ws2812 "WS2812 device struct" to a color byte.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It looks up the color byte in the LUT of the device, if any, and returns
+ * it scaled by `(c * (brightness + 1)) >> 8`, which is the same correction the transmit
+ * loops apply, for paths that correct colors ahead of the transmission.
+ *
+ */
+uint8_t _ws2812_correct(ws2812 *dev, uint8_t c);
+
+/**
+ * @brief Corrects the next pixel of every lane of a parallel transmission into a scratch buffer.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It stores the color order mapped, LUT corrected and brightness scaled
+ * bytes of the next RGB value of n_lanes lanes in v, ordered as they are transmitted
+ * (v[j * n_lanes + l] holds byte j of lane l), and advances the lanes to their next RGB value.
+ * Lanes set to `NULL` are stored as 0. The LUT corrected bytes are accounted in the
+ * @ref ws2812_power "power struct" of the device, if any, once per lane.
+ */
+void _ws2812_correct_lanes(ws2812 *dev, ws2812_rgb *lanes[], uint8_t n_lanes, uint8_t *v);
+
 /**
  * @brief Configures a @ref ws2812 "WS2812 device struct". 
  *
@@ -107,6 +165,308 @@ void _ws2812_get_rgbmap(uint8_t (*rgbmap)[3], ws2812_order order);
  */
 uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg);
 
+/**
+ * @brief Sets the global brightness of a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function sets the brightness by which every color byte is scaled
+ * as it is transmitted, where a brightness of 255 (the default set by #ws2812_config())
+ * transmits colors unaltered, and a brightness of 0 transmits all colors as 0.
+ * Every byte is scaled by `(c * (brightness + 1)) >> 8` right before being shifted out,
+ * thus dimming requires neither a copy of the frame nor an extra pass over it.
+ * 
+ * The scaling is done in the low phase between two bytes, using `mul` on AVR chips
+ * that provide it, a shift-and-add sequence on AVR chips that do not, and `mul` on STM8S
+ * chips. On ESP32 chips, it is done by the RMT interrupt as the bytes are translated into RMT items.
+ * On RP2040 chips, it is done by the CPU as the bytes are written to the PIO, or by ws2812_tx_async()
+ * in a single pass over the frame before it is handed to the DMA.
+ * For a brightness of 255 the scaling is skipped entirely.
+ *
+ * If a current budget is set through ws2812_set_power(), the brightness is the upper bound of
+ * the limiter. Lowering it takes effect immediately, while raising it takes effect once the
+ * limiter has corrected the brightness at the end of the next frame.
+ *
+ */
+void ws2812_set_brightness(ws2812 *dev, uint8_t brightness);
+
+/**
+ * @brief Sets the color correction lookup table of a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function sets a 256 entry lookup table (LUT) through which every color
+ * byte is translated right before being shifted out, ex. for gamma correction or white balance.
+ * The frame itself is left untouched, thus the linear values remain available for blending.
+ * Passing `NULL` (the default set by #ws2812_config()) disables the lookup.
+ * 
+ * On AVR chips (including the AVR USART target), the LUT must reside in flash (`PROGMEM` or `__flash`) within the
+ * lower 64 KiB. On STM8S chips (including the STM8S SPI target), ESP32 and RP2040 chips, it may reside in flash or RAM.
+ * 
+ * The lookup is applied before the brightness set by #ws2812_set_brightness().
+ * To apply both at the cost of a single lookup, fold the brightness into the LUT
+ * (ex. `lut[i] = (gamma(i) * (brightness + 1)) >> 8`) and leave the brightness at 255,
+ * in which case the scaling is skipped.
+ *
+ */
+void ws2812_set_lut(ws2812 *dev, const uint8_t *lut);
+
+/**
+ * @brief Sets the timer used to track the reset of a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function enables non-blocking resets. Once a timer is set,
+ * #ws2812_close_tx() no longer waits for the WS2812 device(s) to reset, but merely records
+ * the time at which the transmission has been closed and returns immediately. The next call
+ * to #ws2812_prep_tx() then only waits for what remains of the reset time, thus the time
+ * in between (ex. to compute the next frame) is no longer wasted.
+ * 
+ * The timer must return a free running microsecond count, of which only the lower
+ * 16 bits are used, so that overflows are handled gracefully (ex. a wrapper around
+ * `micros()` on Arduino, or a hardware timer ticking at 1 MHz).
+ * Passing `NULL` (the default set by #ws2812_config()) restores the blocking behaviour.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to track the reset of
+ * @param now_us Function returning the current time in us
+ */
+void ws2812_set_timer(ws2812 *dev, uint16_t (*now_us)(void));
+
+/**
+ * @brief Sets the interrupt policy of a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function sets when interrupts may be served while the WS2812 device(s) are
+ * programmed, thus turning the trade-off between the interrupt latency of the application
+ * (ex. UART or USB service) and the integrity of the transmitted frames into an explicit choice:
+ * - #ws2812_irq_frame: Interrupts are disabled from #ws2812_prep_tx() until #ws2812_close_tx(),
+ *   hence no interrupt can tear the frame, not even between two transmission calls.
+ * - #ws2812_irq_call: Interrupts are disabled for every transmission call and served between
+ *   the calls (default on AVR platforms).
+ * - #ws2812_irq_pxls: Interrupts are additionally served every n_pxls LEDs of a transmission call
+ *   (default on STM8S platforms, with n_pxls = 1).
+ * - #ws2812_irq_level: As #ws2812_irq_pxls, but only interrupts whose software priority has been
+ *   set to level 3 (ITC_SPR1 to ITC_SPR8, ex. through ITC_SetSoftwarePriority()) are served, as the
+ *   CPU is raised to interrupt level 2 within the windows. All other interrupts are held off until
+ *   the transmission call returns. Only available on STM8S platforms, AVR platforms lack interrupt
+ *   levels and treat it as #ws2812_irq_call.
+ *
+ * Since every LED takes roughly 30us to be transmitted, interrupts are held off for at most
+ * n_pxls * 30us under #ws2812_irq_pxls, plus the overhead of the transmission call. Pending
+ * interrupts are served within the windows between the LEDs, during which the data line is held low.
+ * The interrupt handlers must thus return well before the WS2812 device(s) latch (see #ws2812_set_stats()
+ * to track the longest gap). Windows are only opened if interrupts were enabled by the caller.
+ * On STM8S platforms, the interrupt level of the caller (I1 and I0 of the CC register) is saved and
+ * restored, thus transmissions from within an interrupt handler return at the level of the handler.
+ * As STM8S transmissions share a static scratch, handlers served within a window must not transmit
+ * to any WS2812 device themselves.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to set the interrupt policy of
+ * @param irq Interrupt policy
+ * @param n_pxls Number of LEDs between two interrupt windows (only used by #ws2812_irq_pxls, 0 is treated as 1)
+ *
+ * @note Only available on the AVR and STM8S targets, as the remaining targets do not
+ *      disable interrupts while transmitting.
+ * @warning The policy must not be changed between #ws2812_prep_tx() and #ws2812_close_tx().
+ */
+#if defined(WS2812_TARGET_PLATFORM_AVR) || defined(WS2812_TARGET_PLATFORM_ARDUINO_AVR) || \
+    defined(WS2812_TARGET_PLATFORM_STM8S)
+void ws2812_set_irq(ws2812 *dev, ws2812_irq irq, uint8_t n_pxls);
+#endif
+
+#ifdef WS2812_STATS
+/**
+ * @brief Attaches a @ref ws2812_stats "stats struct" to a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function clears the provided @ref ws2812_stats "stats struct" and attaches it to the
+ * device, which from then on records the duration, the number of bytes and the gaps of every frame.
+ * The statistics are taken from the timer set by #ws2812_set_timer(), which is read only at the start
+ * and the end of every transmission call, and around every interrupt window, rather than per byte,
+ * thus recording is cheap enough to be left enabled in production builds. No statistics are recorded
+ * while no timer is set.
+ *
+ * On the bit-banged AVR and STM8S targets, the interrupt windows opened within a transmission call
+ * (see #ws2812_set_irq()) are measured as gaps of their own, as the interrupts served in them hold the
+ * data line low. Other gaps within a single transmission call (ex. ws2812_tx_gen() waiting for its
+ * generator) are not measured individually, but add to the frame duration, which thus exceeds the
+ * nominal 10us per byte (16us on the STM8S SPI target) by their sum. For background transmissions
+ * (ws2812_tx_async()), the time at which the last byte is shifted out is derived from the number of bytes.
+ *
+ * Passing `NULL` (the default set by #ws2812_config()) detaches the current stats struct.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to record the statistics of
+ * @param stats @ref ws2812_stats "Stats struct" to be filled
+ * @param late_us Gaps longer than this are counted as latch risks (ex. 5, as some WS2812
+ *      devices already latch after less than 10us, regardless of their specified reset time)
+ *
+ * @note Only available if the build flag `WS2812_STATS` is set.
+ */
+void ws2812_set_stats(ws2812 *dev, ws2812_stats *stats, uint16_t late_us);
+
+/**
+ * @brief Records the start of a transmission call in the @ref ws2812_stats "stats" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It starts a new frame, or measures the gap since the end of the previous
+ * transmission call of the frame.
+ */
+void _ws2812_stats_begin(ws2812 *dev);
+
+/**
+ * @brief Records the end of a transmission call in the @ref ws2812_stats "stats" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. pending_us is the time the bytes that have not been shifted out yet take
+ * once the call returns (ex. the bytes buffered by a peripheral, or all bytes of a background
+ * transmission), and thus by which the gap following the call begins later.
+ */
+void _ws2812_stats_end(ws2812 *dev, size_t n_bytes, uint16_t pending_us);
+
+/**
+ * @brief Records the start of a gap within a transmission call in the @ref ws2812_stats "stats" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It is called right before the data line is left idle within a transmission
+ * call (ex. to open an interrupt window).
+ */
+void _ws2812_stats_pause(ws2812 *dev);
+
+/**
+ * @brief Records the end of a gap within a transmission call in the @ref ws2812_stats "stats" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It measures the gap since the last call of _ws2812_stats_pause().
+ */
+void _ws2812_stats_resume(ws2812 *dev);
+#else
+#define _ws2812_stats_begin(dev)
+#define _ws2812_stats_end(dev, n_bytes, pending_us) ((void) (n_bytes))
+#define _ws2812_stats_pause(dev)
+#define _ws2812_stats_resume(dev)
+#endif
+
+#ifdef WS2812_POWER
+/**
+ * @brief Attaches a @ref ws2812_power "power struct" to a @ref ws2812 "WS2812 device struct".
+ *
+ * The following function clears the provided @ref ws2812_power "power struct" and attaches it to the
+ * device, which from then on limits the estimated current draw of its frames to budget_ma. Rather
+ * than summing and rescaling the frame ahead of every transmission, the color bytes are accumulated
+ * by the transmission calls themselves, and the brightness of the device is corrected from one frame
+ * to the next once the frame has been closed. The correction is then applied by the same per byte
+ * brightness scaling as #ws2812_set_brightness(), thus a frame that is considerably brighter than its
+ * predecessor may exceed the budget for a single frame. The estimated draw of the last frame is
+ * provided as the draw_ma field.
+ *
+ * The colors of #ws2812_tx(), #ws2812_tx_fill(), #ws2812_tx_rle() and #ws2812_tx_gen() (and thus
+ * #ws2812_tx_layout()), of ws2812_tx_P() and ws2812_tx_PF() on AVR targets, and of ws2812_tx_async() on
+ * the targets that provide it, are accounted once for every data pin they are output on (ex. only the
+ * pins of the first port of a device spanning two ports on the Arduino AVR target). The lanes of #ws2812_tx_parallel() are accounted once each. On the bit-banged AVR and
+ * STM8S targets, the colors of #ws2812_tx(), #ws2812_tx_gen(), #ws2812_tx_indexed(), #ws2812_tx_raw() and
+ * ws2812_tx_P()/ws2812_tx_PF() are summed by the transmit loop, in the low phase between two bytes, while those of #ws2812_tx_parallel()
+ * are summed as every pixel of the lanes is corrected ahead of its transmission.
+ *
+ * The bytes of #ws2812_tx_indexed() and #ws2812_tx_raw() are accounted just as well, in whatever color
+ * order they are in, as the sum of a pixel does not depend on the order of its channels. Only
+ * ws2812_tx_encoded() bypasses the limiter: its bytes have been corrected by ws2812_encode() already and
+ * are transmitted as they are, thus they are neither accounted nor scaled down, and frames transmitted
+ * through it are neither held to the budget nor included in the estimated draw.
+ *
+ * Passing `NULL` (the default set by #ws2812_config()) detaches the current power struct, leaving
+ * the device at the last brightness set by the limiter.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to limit the current draw of
+ * @param power @ref ws2812_power "Power struct" to hold the budget and the estimated draw
+ * @param budget_ma Current budget in mA
+ *
+ * @note Only available if the build flag `WS2812_POWER` is set. The current drawn by a single color
+ *      channel at full intensity is set by `WS2812_MA_PER_CHANNEL` (20 mA by default).
+ */
+void ws2812_set_power(ws2812 *dev, ws2812_power *power, uint16_t budget_ma);
+
+/**
+ * @brief Accounts RGB values in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds the LUT corrected color bytes of n_pxls RGB values, transmitted on all
+ * data pins of the device, to the current frame.
+ */
+void _ws2812_power_pxls(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief Accounts a sum of color bytes in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds a sum of LUT corrected color bytes, accumulated by a transmit loop and
+ * transmitted on all data pins of the device, to the current frame.
+ */
+void _ws2812_power_add(ws2812 *dev, uint32_t sum);
+
+/**
+ * @brief Accounts raw color bytes in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds n_bytes LUT corrected bytes, transmitted on all data pins of the device,
+ * to the current frame. As the sum of a pixel does not depend on the order of its channels,
+ * the bytes may be in any color order.
+ */
+void _ws2812_power_bytes(ws2812 *dev, const uint8_t *bytes, size_t n_bytes);
+
+/**
+ * @brief Accounts palette indexed LEDs in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds the LUT corrected palette entries of n_pxls indices, packed as for
+ * #ws2812_tx_indexed() and transmitted on all data pins of the device, to the current frame.
+ */
+void _ws2812_power_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                           const ws2812_rgb *palette, size_t n_pxls);
+
+/**
+ * @brief Accounts a run of equally colored LEDs in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds the LUT corrected color bytes of n_pxls LEDs set to color, transmitted on
+ * all data pins of the device, to the current frame.
+ */
+void _ws2812_power_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls);
+
+/**
+ * @brief Accounts the lanes of a parallel transmission in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It adds the LUT corrected color bytes of n_pxls RGB values of every lane to the
+ * current frame, where every lane is output on a single data pin. Lanes set to NULL are skipped.
+ */
+void _ws2812_power_lanes(ws2812 *dev, ws2812_rgb *lanes[], uint8_t n_lanes, size_t n_pxls);
+
+/**
+ * @brief Closes the current frame in the @ref ws2812_power "power struct" of a device.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It estimates the draw of the current frame and sets the brightness for the next one.
+ */
+void _ws2812_power_close(ws2812 *dev);
+#else
+#define _ws2812_power_pxls(dev, pxls, n_pxls)
+#define _ws2812_power_add(dev, sum) ((void) (sum))
+#define _ws2812_power_bytes(dev, bytes, n_bytes)
+#define _ws2812_power_indexed(dev, indices, bits_per_index, palette, n_pxls)
+#define _ws2812_power_fill(dev, color, n_pxls)
+#define _ws2812_power_lanes(dev, lanes, n_lanes, n_pxls)
+#define _ws2812_power_close(dev)
+#endif
+
+/**
+ * @brief Starts the reset of a @ref ws2812 "WS2812 device".
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It records the start of the reset if a timer is set, and otherwise
+ * waits for the reset by calling #ws2812_wait_rst().
+ */
+void _ws2812_begin_rst(ws2812 *dev);
+
+/**
+ * @brief Waits for what remains of a reset started by #_ws2812_begin_rst().
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It returns immediately if no reset is pending.
+ */
+void _ws2812_finish_rst(ws2812 *dev);
+
 /**
  * @brief Prepares the host device for data transmission. 
  *
@@ -137,6 +497,242 @@ void ws2812_prep_tx(ws2812 *dev);
  */
 void ws2812_tx(ws2812 *dev, ws2812_rgb *pxls, size_t n_pxls);
 
+/**
+ * @brief Maps RGB values to the color order of the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function rearranges the bytes of the provided RGB values in place, so that
+ * they are held in the color order of the provided @ref ws2812 "WS2812 device" (ex. GRB).
+ * It is intended to be called once at setup time for data that is transmitted without being
+ * mapped to the color order of the device, such as the palette of #ws2812_tx_indexed() or the
+ * bytes of #ws2812_tx_raw().
+ *
+ * @note Once mapped, the r, g and b fields of the RGB values no longer correspond
+ *      to their color.
+ */
+void ws2812_map_rgb(ws2812 *dev, ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief Transmits palette indexed RGB values to the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function programs n_pxls LEDs of the provided @ref ws2812 "WS2812 device"
+ * with colors of a palette, where every LED is represented by a 1, 2, 4 or 8 bit index
+ * into the palette. Indices are packed from the most significant bit of every byte
+ * onwards, meaning that for 4 bit indices, the upper nibble of `indices[0]` holds the
+ * index of the first LED. With 4 bit indices, a frame takes up a sixth of the memory of an
+ * RGB array.
+ * 
+ * The palette is transmitted as is, and must thus be mapped to the color order of the device
+ * with #ws2812_map_rgb() beforehand.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param indices Packed palette indices, one for every LED
+ * @param bits_per_index Bits per index (1, 2, 4 or 8). Nothing is transmitted for other values.
+ * @param palette Color order mapped palette with 2^bits_per_index entries
+ * @param n_pxls Number of LEDs to be programmed
+ */
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                       const ws2812_rgb *palette, size_t n_pxls);
+
+/**
+ * @brief Transmits RGB values fetched from a pixel generator to the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function programs n_pxls LEDs of the provided @ref ws2812 "WS2812 device"
+ * with RGB values returned by the provided generator callback, which is called once for every
+ * LED, right before its RGB value is transmitted. This allows entire frames to be computed on
+ * the fly, without the need of an RGB array equivalent to the number of LEDs.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param gen Generator callback returning the RGB value of the LED at position idx
+ * @param ctx User pointer passed on to the generator callback
+ * @param n_pxls Number of LEDs to be programmed
+ *
+ * @warning The data line idles low while the generator callback is running, thus the callback
+ *      must return well before the WS2812 device(s) latch, or the remaining LEDs will be programmed
+ *      from the first LED again. As a rule of thumb, the callback, including the call overhead
+ *      (roughly 30 CPU cycles), should not take longer than half of the reset time of the device.
+ *      For a WS2812B with a reset time of 50us, that is roughly 200 cycles at 8 MHz or 400 cycles at 16 MHz.
+ *      Older WS2812 devices may latch after less than 10us, regardless of their datasheet.
+ *      On AVR platforms, interrupts are disabled for the entire transmission, including the callbacks,
+ *      unless interrupt windows have been enabled through #ws2812_set_irq().
+ *
+ * @note On ESP32 targets, the frame is transmitted as a single RMT transmission, and the generator
+ *      callback is called by the RMT translator, thus from the RMT interrupt, while the previous LEDs are
+ *      played back. The callback must hence be safe to be called from an interrupt, and must return
+ *      before the other half of the RMT memory block has been played back (roughly 40us).
+ */
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls);
+
+/**
+ * @brief Programs multiple LEDs of the provided @ref ws2812 "WS2812 device" with the same color.
+ *
+ * The following function programs n_pxls LEDs of the provided @ref ws2812 "WS2812 device"
+ * with the same RGB value, without requiring an RGB array equivalent to the number of LEDs.
+ * Consecutive calls continue programming LEDs after the position where the last transmission
+ * has ended.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param color RGB value to be transmitted
+ * @param n_pxls Number of LEDs to be programmed
+ */
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls);
+
+/**
+ * @brief Transmits run-length encoded RGB values to the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function programs the provided @ref ws2812 "WS2812 device" with a frame
+ * made up of @ref ws2812_run "runs" of equally colored LEDs (ex. status bars or segments). Each run
+ * is transmitted as in #ws2812_tx_fill().
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param runs Array of runs
+ * @param n_runs Number of runs
+ */
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs);
+
+/**
+ * @brief Transmits a logical frame buffer to the provided @ref ws2812 "WS2812 device" in physical order.
+ *
+ * The following function programs an LED matrix or fixture, wired as described by the provided
+ * @ref ws2812_layout "layout", with a frame buffer of layout->width * layout->height RGB values that
+ * is stored row by row in logical order (ex. pxls[y * width + x]). Rather than building a physically
+ * ordered copy of the frame buffer, the rows are transmitted in the order in which they are wired:
+ * - Rows wired from their first LED are transmitted as they are stored.
+ * - Rows wired from their last LED (WS2812_LAYOUT_REVERSED, or every second row of a
+ *   WS2812_LAYOUT_SERPENTINE layout) are transmitted backwards.
+ * - With WS2812_LAYOUT_MIRRORED, all rows are then transmitted once more in the reverse order,
+ *   thus driving a chain of twice the length of the frame buffer.
+ *
+ * On the bit-banged AVR and STM8S targets, the entire layout is transmitted in a single pass,
+ * with the transmit loop stepping backwards through the frame buffer for rows wired from their
+ * last LED. On the remaining targets (and for devices spanning two ports on the Arduino AVR target),
+ * rows wired from their first LED are transmitted through #ws2812_tx() and rows wired from their last LED
+ * through #ws2812_tx_gen(), thus the data line idles low between two rows for as long as the
+ * call overhead takes.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param layout Wiring of the LEDs
+ * @param pxls Frame buffer in logical order
+ */
+void ws2812_tx_layout(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls);
+
+/**
+ * @brief Returns a row of a @ref ws2812_layout "layout" in the order in which it is wired.
+ *
+ * The following function is intended only to be used for internal library code, hence the _ prefix.
+ * It returns the first RGB value of the i-th row along the chain of LEDs, and sets rev if the row is
+ * wired from its last LED. Once i runs past the last row of the chain, `NULL` is returned.
+ */
+const ws2812_rgb *_ws2812_layout_row(const ws2812_layout *layout, const ws2812_rgb *pxls, uint16_t i, bool *rev);
+
+/**
+ * @brief Transmits a @ref ws2812_layout "layout" row by row.
+ *
+ * The following function is intended only to be used for internal library code, hence the _ prefix.
+ * It implements #ws2812_tx_layout() through one #ws2812_tx() or #ws2812_tx_gen() call per row, for
+ * the targets whose transmit loops cannot step backwards through the frame buffer.
+ */
+void _ws2812_tx_layout_rows(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls);
+
+/**
+ * @brief Transmits a raw stream of bytes to the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function transmits bytes to the provided @ref ws2812 "WS2812 device"
+ * exactly as given, without mapping them to the color order of the device. It is the
+ * fastest way to program a WS2812 device, given that the data is already held in the color
+ * order of the device (ex. GRB), and allows to drive devices with any number of color
+ * channels (ex. RGBW SK6812 devices).
+ * 
+ * Just like #ws2812_tx(), consecutive calls continue programming LEDs after the position
+ * where the last transmission has ended.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param bytes Bytes to be transmitted, in the order expected by the device
+ * @param n_bytes Number of bytes to be transmitted
+ */
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes);
+
+#if defined(WS2812_TARGET_PLATFORM_AVR_USART) || defined(WS2812_TARGET_PLATFORM_STM8S_SPI) || \
+    defined(WS2812_TARGET_PLATFORM_ESP32) || defined(WS2812_TARGET_PLATFORM_RP2040)
+/**
+ * @brief Encodes RGB values into the bitstream of the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function encodes RGB values once into the representation that is handed to
+ * the peripheral of the device (ex. SPI bytes or RMT items), so that static frames, or a few
+ * alternating ones, can be replayed through #ws2812_tx_encoded() without encoding them again on
+ * every refresh. The color order, LUT and brightness are applied as set at the time of encoding.
+ *
+ * A buffer of WS2812_ENCODED_SIZE(n_pxls) bytes is sufficient for any device of the target:
+ * - AVR USART and STM8S SPI: 4 SPI bytes per color byte
+ * - ESP32: 8 RMT items (32 bytes) per color byte
+ * - RP2040: 1 byte per color byte for devices with a single pin, 8 bit slices
+ *   (two 32 bit words) per color byte for devices with multiple pins
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to encode the RGB values for
+ * @param pxls RGB values to be encoded
+ * @param n_pxls Number of RGB values to be encoded
+ * @param buf Buffer to hold the encoded bitstream (must be 4 byte aligned on ESP32 and RP2040, ex. an array of uint32_t)
+ * @param buf_size Size of the buffer in bytes
+ *
+ * @return Size of the encoded bitstream in bytes, or 0 if the buffer is too small.
+ */
+size_t ws2812_encode(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls, void *buf, size_t buf_size);
+
+/**
+ * @brief Transmits a bitstream encoded by #ws2812_encode() to the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function hands the encoded bitstream to the peripheral of the device as it is,
+ * thus no CPU time is spent on encoding. On the ESP32 and STM8S SPI targets, as well as for RP2040
+ * devices with a single pin, the bitstream is transmitted in the background, just as through
+ * ws2812_tx_async(), by the RMT driver, the SPI interrupt (see ws2812_spi_isr()) or DMA respectively.
+ * The buffer must then not be altered until #ws2812_tx_done() returns true. On the AVR USART target,
+ * and for RP2040 devices with multiple pins, the function returns once the bitstream has been
+ * handed to the peripheral.
+ *
+ * Just like #ws2812_tx(), the transmission must be embedded between #ws2812_prep_tx()
+ * and #ws2812_close_tx(), and the bitstream must have been encoded for the same device.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param buf Encoded bitstream
+ * @param n_bytes Size of the encoded bitstream in bytes, as returned by #ws2812_encode()
+ */
+void ws2812_tx_encoded(ws2812 *dev, const void *buf, size_t n_bytes);
+#endif
+
+/**
+ * @brief Transmits independent RGB values to every data pin of the provided @ref ws2812 "WS2812 device".
+ *
+ * The following function programs up to 8 WS2812 devices attached to the data pins of a
+ * @ref ws2812 "WS2812 device struct" in parallel, each with its own RGB values. Unlike
+ * #ws2812_tx(), which outputs the same data on all data pins, the RGB values of all lanes
+ * are bit sliced on the fly, so that every bit slot writes a different bit to every data pin within
+ * a single port write. This allows multiple WS2812 devices to be programmed in nearly the
+ * time it takes to program a single one.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" configured with the data pins of all lanes
+ * @param lanes Array of 8 RGB arrays, where `lanes[n]` holds the RGB values for the data pin at
+ *      bit n of the port (ex. `lanes[3]` for PB3 or GPIO_PIN_3). Lanes of unused pins are ignored
+ *      and may be NULL. On the Arduino AVR target, devices spanning two ports take an array of
+ *      16 RGB arrays, where `lanes[8 + n]` holds the RGB values for the data pin at bit n of the second port.
+ * @param n_pxls Number of RGB values to transmit per lane
+ *
+ * @note The bit slicing is done between the bits, thus the low phase of every bit is slightly
+ *      stretched. On the bit-banged AVR and STM8S targets, every pixel of all lanes is corrected
+ *      by the LUT and brightness ahead of its transmission, leaving only the loads of the next lane
+ *      bytes between two bytes (held below 5us, apart from devices spanning two ports at 8 MHz). The correction
+ *      stretches the low phase between two pixels instead, which takes considerably longer than
+ *      in #ws2812_tx() and may come close to the reset time of older WS2812 devices on slow clocks.
+ * @note Not available on the AVR USART and STM8S SPI targets, as they only provide a single data pin.
+ *      Neither is it available on the ESP32 target, where every RMT channel outputs a single waveform.
+ *      Configure one @ref ws2812 "WS2812 device struct" per RMT channel and transmit to them through
+ *      ws2812_tx_async() instead.
+ * @note On the RP2040 target, the lanes are bit sliced on the CPU and shifted out by the PIO, where
+ *      lane n is output on the n-th GPIO above the lowest configured pin.
+ */
+#if !defined(WS2812_TARGET_PLATFORM_AVR_USART) && !defined(WS2812_TARGET_PLATFORM_STM8S_SPI) && \
+    !defined(WS2812_TARGET_PLATFORM_ESP32)
+void ws2812_tx_parallel(ws2812 *dev, ws2812_rgb *lanes[], size_t n_pxls);
+#endif
+
 /**
  * @brief Waits for the @ref ws2812 "WS2812 device" to reset.
  *
@@ -160,5 +756,130 @@ void ws2812_wait_rst(ws2812 *dev);
  * typically involve restoring stashed registers to their previous states, 
  * re-enable interrupts, wait for the WS2812 to reset by calling #ws2812_wait_rst(),
  * and potentially alter fields of the provided @ref ws2812 "WS2812 device struct".
+ * 
+ * If a timer has been set with #ws2812_set_timer(), the reset is not waited for here,
+ * but rather by the next #ws2812_prep_tx() call, and only for as long as it has not elapsed yet.
+ */
+void ws2812_close_tx(ws2812 *dev);
+
+/**
+ * @brief Restores the host device after a WS2812 transmission without waiting for the reset.
+ *
+ * The following function is intended only to be used for internal library code, hence
+ * the _ prefix. It performs the platform specific part of #ws2812_close_tx(), that is,
+ * restoring stashed registers and clearing the preperation state of the
+ * @ref ws2812 "WS2812 device struct", but does not wait for the WS2812 device(s) to reset.
+ */
+void _ws2812_release_tx(ws2812 *dev);
+
+/**
+ * @brief Transmits RGB values to multiple @ref ws2812 "WS2812 devices" in one pass.
+ *
+ * The following function prepares, programs and closes the transmission of multiple
+ * @ref ws2812 "WS2812 devices" (ex. strips on different ports) back-to-back. Rather than
+ * waiting for every device to reset individually, the reset time is waited for only once,
+ * after the last device has been programmed, using the longest reset time of all devices.
+ *
+ * @param devs Array of @ref ws2812 "WS2812 device structs" to be programmed
+ * @param pxls Array of RGB arrays, one for each device
+ * @param n_pxls Array holding the number of RGB values to transmit for each device
+ * @param n_devs Number of devices
+ *
+ * @note Since the state of a transmission is held in the @ref ws2812 "WS2812 device struct",
+ *      multiple devices may also be prepared simultaneously and be programmed in an interleaved
+ *      manner through #ws2812_tx(), as long as switching between devices happens faster than
+ *      their reset time.
+ */
+void ws2812_tx_multi(ws2812 *devs[], ws2812_rgb *pxls[], size_t n_pxls[], uint8_t n_devs);
+
+/**
+ * @brief Initializes a @ref ws2812_frame "frame" to track changes of a frame buffer.
+ *
+ * The following function initializes a @ref ws2812_frame "frame" for the provided frame buffer.
+ * The entire frame is marked as changed, thus the first #ws2812_frame_refresh() call
+ * programs all LEDs.
+ *
+ * @param frm @ref ws2812_frame "Frame" to be initialized
+ * @param pxls Frame buffer
+ * @param n_pxls Number of LEDs in the frame buffer
+ */
+void ws2812_frame_init(ws2812_frame *frm, ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief Sets the color of a LED in a @ref ws2812_frame "frame".
+ *
+ * The following function sets the color of the LED at the provided index and, if the
+ * color differs from the previous one, marks the frame as changed up to that LED.
+ * Indices beyond the frame buffer are ignored.
+ *
+ * @param frm @ref ws2812_frame "Frame" holding the LED
+ * @param idx Index of the LED
+ * @param color New color of the LED
+ */
+void ws2812_frame_set(ws2812_frame *frm, size_t idx, ws2812_rgb color);
+
+/**
+ * @brief Marks a @ref ws2812_frame "frame" as changed up to the provided LED.
+ *
+ * The following function is intended for changes written to the frame buffer directly,
+ * rather than through #ws2812_frame_set(). Indices beyond the frame buffer are clamped
+ * to the last LED.
+ *
+ * @param frm @ref ws2812_frame "Frame" to be marked
+ * @param idx Index of the last changed LED
+ */
+void ws2812_frame_mark(ws2812_frame *frm, size_t idx);
+
+/**
+ * @brief Transmits the changed portion of a @ref ws2812_frame "frame".
+ *
+ * The following function prepares, programs and closes a transmission to the provided
+ * @ref ws2812 "WS2812 device", where only the LEDs up to the highest changed index since
+ * the last refresh are transmitted. The remaining LEDs keep their colors. If nothing has
+ * changed, nothing is transmitted.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param frm @ref ws2812_frame "Frame" to be refreshed
+ *
+ * @note The transmission is closed by #ws2812_close_tx(), hence a refresh may not be
+ *      embedded into an ongoing transmission of the same device.
+ */
+void ws2812_frame_refresh(ws2812 *dev, ws2812_frame *frm);
+
+/**
+ * @brief Initializes a @ref ws2812_sched "scheduler" to pace frames at a fixed rate.
+ *
+ * @param sched @ref ws2812_sched "Scheduler" to be initialized
+ * @param pxls Frame buffer, filled by the render callback of #ws2812_sched_run()
+ * @param n_pxls Number of LEDs in the frame buffer
+ * @param fps Target frame rate in frames per second (must not be 0)
+ */
+void ws2812_sched_init(ws2812_sched *sched, ws2812_rgb *pxls, size_t n_pxls, uint8_t fps);
+
+/**
+ * @brief Renders and transmits frames at the fixed rate of a @ref ws2812_sched "scheduler".
+ *
+ * The following function repeatedly calls the render callback to fill the frame buffer
+ * of the scheduler, waits for the deadline of the frame and transmits it to the provided
+ * @ref ws2812 "WS2812 device", until the render callback returns false. Deadlines are spaced
+ * by the frame period, regardless of the time it takes to render and transmit a frame, thus
+ * frames are transmitted at a steady rate, and the render callback may use up all of the
+ * frame period that is not taken by the transmission itself.
+ *
+ * Since the deadlines are taken from the timer set by #ws2812_set_timer(), #ws2812_close_tx()
+ * does not wait for the reset, and the next frame is rendered while the WS2812 device(s) latch
+ * the previous one. If no timer is set, the function returns right away.
+ *
+ * A frame that is rendered past its deadline is transmitted right away. Every deadline that has
+ * passed by then is counted in `n_missed`, and the frame index is advanced past the skipped frames,
+ * so that animations keep their pace.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param sched @ref ws2812_sched "Scheduler" to pace the frames
+ * @param render Function filling `sched->pxls` with frame `sched->frame`, returning false to stop the scheduler
+ * @param ctx Context passed to the render callback
+ *
+ * @note The timer is only read between frames, hence rendering and transmitting a frame
+ *      must take less than 65ms, beyond which the 16 bit timer overflows unnoticed.
  */
-void ws2812_close_tx(ws2812 *dev);
\ No newline at end of file
+void ws2812_sched_run(ws2812 *dev, ws2812_sched *sched, bool (*render)(ws2812_sched *sched, void *ctx), void *ctx);
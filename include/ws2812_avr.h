@@ -28,6 +28,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 #include "ws2812_common.h"
 #include "ws2812.h"
@@ -58,22 +60,36 @@
  * WS2812 devices on AVR based devices. The data structure varies for the Arduino AVR 
  * target and the barebone AVR target.
  * 
+ * If the build flag `WS2812_AVR_IO_PORT` is set to a port in the I/O space (ex. `PORTB`, or
+ * `VPORTB_OUT` on megaAVR-0, tinyAVR-0/1 and AVR-Dx chips), the port is written through the
+ * 1 cycle `out` instruction rather than through `st`, which tightens the timing on low clocked
+ * chips (ex. 8 MHz internal oscillators). The port of the configuration (or, on the Arduino AVR
+ * target, the port of all pins) must then match the port of the build flag, otherwise
+ * ws2812_config() returns 3.
+ * 
+ * On the Arduino AVR target, the pins may span two ports (ex. PORTA and PORTC for pins 22-37 of the
+ * Arduino Mega), of which the port of the first pin is considered the first port. Both ports are
+ * written in the same bit slots by ws2812_tx_parallel(), which thus drives up to 16 lanes at once,
+ * and by ws2812_tx(), which is then transmitted through ws2812_tx_parallel(). All other transmission
+ * calls only program the pins of the first port. Pins spanning more than two ports are rejected by
+ * ws2812_config(), which returns 2.
+ * 
  * WARNING: All fields of the configuration object must be defined before passing it to #ws2812_config()!
  *      Leaving a field undefined will result in undefined behaivor!
  */
 typedef struct ws2812_cfg {
 
 #ifdef WS2812_TARGET_PLATFORM_AVR
-        volatile uint8_t *port;   ///< PORT Register (ex. PORTB, PORTC, PORTD...) 
-        volatile uint8_t *ddr;    ///< Data Direction Register (ex. DDRB, DDRC, DDRD...)
+        volatile uint8_t *port;   ///< PORT Register (ex. PORTB, PORTC, PORTD..., or VPORTB.OUT on megaAVR-0, tinyAVR-0/1 and AVR-Dx chips) 
+        volatile uint8_t *ddr;    ///< Data Direction Register (ex. DDRB, DDRC, DDRD..., or VPORTB.DIR on megaAVR-0, tinyAVR-0/1 and AVR-Dx chips)
         uint8_t *pins;            ///< Array of pins used to program WS2812 devices (**Must share the same PORT!** (ex. PB0, PB1, PB2))
 #endif
 
 #ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
-        uint8_t *pins;             ///< Array of pins used to program WS2812 devices (**Must share the same PORT!** (ex. pin 0-7), see https://www.arduino.cc/en/Reference/PortManipulation) 
+        uint8_t *pins;             ///< Array of pins used to program WS2812 devices (**Must span at most two PORTs!** (ex. pin 22-37 on the Mega), see https://www.arduino.cc/en/Reference/PortManipulation) 
 #endif
 
-        uint8_t rst_time_us;      ///< Time required for the WS2812 device(s) to reset in us
+        uint16_t rst_time_us;     ///< Time required for the WS2812 device(s) to reset in us
         ws2812_order order;       ///< CoColor order of the WS2812 device(s) (ex. rgb, grb, bgr...)
         uint8_t n_dev;            ///< Number of WS2812 device to drive
         
@@ -106,8 +122,66 @@ typedef struct ws2812_cfg {
  */
 typedef struct ws2812 {
         volatile uint8_t *port; ///< PORT register of pins used to drive the WS2812 device(s)
-        uint8_t rst_time_us;    ///< Time required for WS2812 to reset in us
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
         uint8_t maskhi;         ///< PORT masks to toggle the data pins high
         uint8_t masklo;         ///< PORT masks to toggle the data pins low
+#ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+        volatile uint8_t *port2; ///< PORT register of the pins on a second port (NULL = none)
+        uint8_t maskhi2;        ///< PORT masks to toggle the data pins of the second port high
+        uint8_t masklo2;        ///< PORT masks to toggle the data pins of the second port low
+#endif
         uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
-} ws2812;
\ No newline at end of file
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        ws2812_irq irq;         ///< Interrupt policy of the device
+        uint8_t irq_pxls;       ///< Number of LEDs between two interrupt windows (ws2812_irq_pxls)
+        uint8_t sreg_prev;      ///< SREG stashed by ws2812_prep_tx()
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
+} ws2812;
+
+#ifdef __AVR_HAVE_LPMX__
+/**
+ * @brief AVR: Transmits RGB values stored in flash to the provided @ref ws2812 "WS2812 device".
+ * 
+ * The following function is the flash equivalent of #ws2812_tx(). It reads RGB values through
+ * the `lpm` instruction directly from the lower 64 KiB of flash (ex. `PROGMEM` or `__flash` data),
+ * thus pre-rendered frames can be transmitted without being copied into SRAM first.
+ * 
+ * The bytes are fetched between two bytes, just as in #ws2812_tx(), hence the timing of
+ * the individual bits is unaffected by the 3 cycle `lpm` instruction. The low phase between two
+ * bytes is one cycle longer than for #ws2812_tx().
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param leds_P Flash address of the RGB values
+ * @param n_leds Number of RGB values to be transmitted
+ */
+void ws2812_tx_P(ws2812 *dev, const ws2812_rgb *leds_P, size_t n_leds);
+#endif
+
+#ifdef __AVR_HAVE_ELPM__
+/**
+ * @brief AVR: Transmits RGB values stored anywhere in flash to the provided @ref ws2812 "WS2812 device".
+ * 
+ * The following function is the far flash equivalent of #ws2812_tx_P() for devices with
+ * more than 64 KiB of flash (ex. ATmega2560). It reads RGB values through the `elpm` instruction
+ * from a 24 bit flash address, as returned by `pgm_get_far_address()` (ex. for `__memx` or
+ * `PROGMEM_FAR` data). RAMPZ is restored after the transmission.
+ * 
+ * The low phase between two bytes is four cycles longer than for #ws2812_tx().
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param leds_PF 24 bit flash address of the RGB values
+ * @param n_leds Number of RGB values to be transmitted
+ */
+void ws2812_tx_PF(ws2812 *dev, uint32_t leds_PF, size_t n_leds);
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_avr_usart.h
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Provides AVR USART (Master SPI mode) platform specific definitions.
+ *
+ */
+
+#pragma once
+
+#ifdef WS2812_TARGET_PLATFORM_AVR_USART
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ws2812_common.h"
+
+/// Size in bytes of the bitstream of n_pxls LEDs, encoded by ws2812_encode() (4 SPI bytes per color byte)
+#define WS2812_ENCODED_SIZE(n_pxls) ((n_pxls) * sizeof(ws2812_rgb) * 4)
+
+/*
+ * AVR USART: Data structure to configure a @ref ws2812 "WS2812 device struct" on AVR platforms,
+ * driven by a USART in Master SPI mode (MSPIM).
+ *
+ * The following struct is used to initialize/configure a @ref ws2812 "WS2812 device struct"
+ * on AVR based devices, where the WS2812 device(s) are driven by the TxD pin of a USART.
+ * It is passed to the ws2812_config() function along with a reference to a
+ * @ref ws2812 "WS2812 device struct", and contains relevant information such as the USART
+ * used to drive WS2812 devices, the device's reset time etc.
+ *
+ * As the bits are shifted out by the USART, only one data line (the TxD pin) is available.
+ * Multiple WS2812 devices may still be driven in parallel by wiring them to the same pin.
+ *
+ * WARNING: All fields of the configuration object must be defined before passing it to #ws2812_config()!
+ *      Leaving a field undefined will result in undefined behaivor!
+ */
+typedef struct ws2812_cfg {
+        volatile uint8_t *usart;   ///< First register of the USART (ex. &UCSR0A, &UCSR1A...)
+        volatile uint8_t *xck_ddr; ///< Data Direction Register of the USART's XCK pin (ex. DDRD), which must be an output in MSPIM
+        uint8_t xck_pin;           ///< XCK pin of the USART (ex. PD4)
+        uint16_t rst_time_us;      ///< Time required for the WS2812 device(s) to reset in us
+        ws2812_order order;        ///< Color order of the WS2812 device(s) (ex. rgb, grb, bgr...)
+} ws2812_cfg;
+
+/*
+ * AVR USART: WS2812 device struct to drive one or more WS2812 devices through a USART in MSPIM.
+ *
+ * The following struct is used to drive one or more WS2812 devices on AVR based devices
+ * through a USART in Master SPI mode. It is initialized by the ws2812_config() function and
+ * is taken as an argument by practically every function of the TinyWS2812 library relevant
+ * to driving WS2812 devices (ex. ws2812_tx(), ws2812_prep_tx(), etc...).
+ *
+ * See ws2812_config()
+ *
+ */
+typedef struct ws2812 {
+        volatile uint8_t *usart; ///< First register of the USART used to drive the WS2812 device(s)
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
+        uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        bool busy;              ///< Flag to indicate if bytes have been written to the USART since the last release
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
+} ws2812;
+
+#endif
@@ -31,6 +31,61 @@
 
 #pragma once
 
+#include <stddef.h>
+
+/*
+ * Timing profiles
+ *
+ * By default, the bit-banged (AVR, STM8S) and the ESP32 targets emit a conservative timing
+ * that is accepted by most WS2812 compatible chips. Setting one of the following build flags
+ * instead selects the typical pulse lengths of a specific chip, at a shorter bit period than the
+ * default that stays within the limits of its datasheet:
+ * - `WS2812_TIMING_WS2812`:  WS2812(S), 1150ns period, 50us reset
+ * - `WS2812_TIMING_WS2812B`: WS2812B, 1050ns period, 280us reset (revision V5 of the datasheet, older
+ *   WS2812B chips accept it as well)
+ * - `WS2812_TIMING_SK6812`:  SK6812, 1050ns period, 80us reset
+ * - `WS2812_TIMING_WS2813`:  WS2813/WS2815, 1050ns period, 280us reset
+ *
+ * The reset time of the selected profile (50us if none is selected) is provided as WS2812_RST_US,
+ * which may be assigned to the rst_time_us field of the device configuration.
+ */
+#if defined(WS2812_TIMING_WS2812) + defined(WS2812_TIMING_WS2812B) + \
+    defined(WS2812_TIMING_SK6812) + defined(WS2812_TIMING_WS2813) > 1
+#error "Only one WS2812 timing profile may be selected"
+#endif
+
+#if defined(WS2812_TIMING_WS2812)
+#define WS2812_T0H_NS     350   ///< Pulse length of a "0" in ns
+#define WS2812_T0H_MAX_NS 500   ///< Longest pulse length of a "0" in ns
+#define WS2812_T1H_NS     700   ///< Pulse length of a "1" in ns
+#define WS2812_T1H_MIN_NS 550   ///< Shortest pulse length of a "1" in ns
+#define WS2812_PERIOD_NS  1150  ///< Bit period in ns
+#define WS2812_RST_US     50    ///< Reset time in us
+#elif defined(WS2812_TIMING_WS2812B)
+#define WS2812_T0H_NS     300
+#define WS2812_T0H_MAX_NS 380
+#define WS2812_T1H_NS     750
+#define WS2812_T1H_MIN_NS 580
+#define WS2812_PERIOD_NS  1050
+#define WS2812_RST_US     280
+#elif defined(WS2812_TIMING_SK6812)
+#define WS2812_T0H_NS     300
+#define WS2812_T0H_MAX_NS 450
+#define WS2812_T1H_NS     600
+#define WS2812_T1H_MIN_NS 450
+#define WS2812_PERIOD_NS  1050
+#define WS2812_RST_US     80
+#elif defined(WS2812_TIMING_WS2813)
+#define WS2812_T0H_NS     300
+#define WS2812_T0H_MAX_NS 380
+#define WS2812_T1H_NS     750
+#define WS2812_T1H_MIN_NS 580
+#define WS2812_PERIOD_NS  1050
+#define WS2812_RST_US     280
+#else
+#define WS2812_RST_US     50
+#endif
+
 /**
  * @brief Enum to specify the WS2812 device's color order.
  *
@@ -50,6 +105,21 @@ typedef enum {
         gbr
 } ws2812_order;
 
+/**
+ * @brief Enum to specify when interrupts may be served while a @ref ws2812 "WS2812 device" is programmed.
+ *
+ * Bit-banged transmissions must not be interrupted mid LED, as any interrupt would stretch the
+ * data signal. Interrupts may however be served in short windows between two LEDs, which holds
+ * the data line low for as long as the interrupts take. The policy is set per device through
+ * ws2812_set_irq().
+ */
+typedef enum {
+        ws2812_irq_frame,       ///< Interrupts are disabled from ws2812_prep_tx() until ws2812_close_tx()
+        ws2812_irq_call,        ///< Interrupts are disabled for every transmission call
+        ws2812_irq_pxls,        ///< Interrupts are served every n LEDs of a transmission call
+        ws2812_irq_level        ///< Only level 3 interrupts are served every n LEDs of a transmission call (STM8S only)
+} ws2812_irq;
+
 #pragma pack(1)
 /**
  * @brief Data structure to hold RGB color values.
@@ -68,4 +138,119 @@ typedef struct ws2812_rgb {
         uint8_t r,g,b;
 } ws2812_rgb;
 
+/**
+ * @brief Data structure to hold a run of equally colored LEDs.
+ *
+ * The run struct holds a color along with the number of consecutive
+ * LEDs that are to be set to it. It is used by the ws2812_tx_rle() function
+ * to program run-length encoded frames.
+ */
+typedef struct ws2812_run {
+        ws2812_rgb color;       ///< Color of the LEDs
+        uint16_t n_pxls;        ///< Number of consecutive LEDs set to the color
+} ws2812_run;
+
+#define WS2812_LAYOUT_SERPENTINE 0x01 ///< Every second row is wired in the opposite direction
+#define WS2812_LAYOUT_REVERSED   0x02 ///< The first row is wired from its last LED to its first LED
+#define WS2812_LAYOUT_FLIPPED    0x04 ///< The rows are wired from the last row to the first row
+#define WS2812_LAYOUT_MIRRORED   0x08 ///< The chain is followed by a mirrored copy of itself (ex. symmetric fixtures)
+
+/**
+ * @brief Data structure to describe the physical order of the LEDs of a matrix or fixture.
+ *
+ * The layout struct describes how a logical frame buffer of height rows with width LEDs each,
+ * stored row by row, is wired. It is used by the ws2812_tx_layout() function to transmit
+ * the frame buffer in physical order, without the need of a physically ordered copy.
+ * Single strips with reversed or mirrored segments are described as a layout of one row.
+ */
+typedef struct ws2812_layout {
+        uint16_t width;         ///< Number of LEDs per row
+        uint16_t height;        ///< Number of rows
+        uint8_t flags;          ///< Wiring of the rows (WS2812_LAYOUT_* flags)
+} ws2812_layout;
+
+/**
+ * @brief Data structure to track the changed portion of a frame.
+ *
+ * The frame struct wraps a frame buffer and records the number of leading LEDs
+ * that must be transmitted to apply all changes made since the last refresh, that is,
+ * the highest changed index + 1. Since WS2812 devices keep the colors of all LEDs
+ * beyond the last transmitted one, ws2812_frame_refresh() only transmits up to that point.
+ */
+typedef struct ws2812_frame {
+        ws2812_rgb *pxls;       ///< Frame buffer
+        size_t n_pxls;          ///< Number of LEDs in the frame buffer
+        size_t n_dirty;         ///< Number of leading LEDs to be transmitted on the next refresh
+} ws2812_frame;
+
+/**
+ * @brief Data structure to pace the frames of a @ref ws2812 "WS2812 device" at a fixed rate.
+ *
+ * The scheduler struct holds the frame buffer and the frame period used by ws2812_sched_run(),
+ * along with the index of the frame being rendered and the number of missed deadlines,
+ * both of which may be read by the render callback (ex. to advance an animation).
+ */
+typedef struct ws2812_sched {
+        ws2812_rgb *pxls;       ///< Frame buffer, filled by the render callback
+        size_t n_pxls;          ///< Number of LEDs in the frame buffer
+        uint32_t period_us;     ///< Frame period in us
+        uint32_t frame;         ///< Index of the frame being rendered, also advanced by skipped frames
+        uint16_t n_missed;      ///< Number of missed deadlines
+} ws2812_sched;
+
+#ifdef WS2812_STATS
+/**
+ * @brief Data structure to hold the transmission statistics of a @ref ws2812 "WS2812 device".
+ *
+ * The stats struct is attached to a @ref ws2812 "WS2812 device struct" through ws2812_set_stats()
+ * and is filled as frames are transmitted. A gap is the time between two transmission calls of
+ * the same frame (ex. ws2812_tx() followed by ws2812_tx_fill()), or an interrupt window within a
+ * transmission call, during which the data line is held low. Gaps that approach the reset time of the WS2812 device(s) risk latching a partial frame.
+ *
+ * frame_us and n_bytes describe the last closed frame, while max_gap_us and n_late accumulate
+ * over all frames until they are cleared by the library user. The fields prefixed with _ hold
+ * the state of the current frame and must not be accessed by the library user.
+ *
+ * Only available if the build flag `WS2812_STATS` is set.
+ */
+typedef struct ws2812_stats {
+        uint16_t late_us;       ///< Gaps longer than this are counted as latch risks
+        uint16_t frame_us;      ///< Duration of the last frame, from its first transmission until it has been closed
+        size_t n_bytes;         ///< Number of color bytes transmitted in the last frame (per data pin)
+        uint16_t max_gap_us;    ///< Longest gap of a frame
+        uint16_t n_late;        ///< Number of gaps longer than late_us
+        uint16_t _start;        ///< Timestamp of the first transmission of the current frame
+        uint16_t _end;          ///< Timestamp at which the last transmission of the current frame has been shifted out
+        uint16_t _pause;        ///< Timestamp at which the current interrupt window has been opened
+        size_t _n_bytes;        ///< Number of color bytes transmitted in the current frame
+        bool _active;           ///< Flag to indicate if a frame is being transmitted
+} ws2812_stats;
+#endif
+
+#ifdef WS2812_POWER
+#ifndef WS2812_MA_PER_CHANNEL
+#define WS2812_MA_PER_CHANNEL 20 ///< Current drawn by a single color channel at full intensity in mA
+#endif
+
+/**
+ * @brief Data structure to hold the current budget of a @ref ws2812 "WS2812 device".
+ *
+ * The power struct is attached to a @ref ws2812 "WS2812 device struct" through ws2812_set_power().
+ * The draw of every frame is estimated from its color bytes as they are transmitted, with each
+ * byte drawing `c * WS2812_MA_PER_CHANNEL / 255` mA. Once the frame has been closed, the brightness
+ * of the device is set for the next frame, such that a frame of equal content stays within the
+ * budget, but never above the brightness requested through ws2812_set_brightness().
+ * The fields prefixed with _ hold the state of the current frame and must not be accessed by
+ * the library user.
+ *
+ * Only available if the build flag `WS2812_POWER` is set.
+ */
+typedef struct ws2812_power {
+        uint16_t budget_ma;     ///< Current budget in mA
+        uint16_t draw_ma;       ///< Estimated draw of the last closed frame in mA, at the brightness it was transmitted with
+        uint8_t brightness;     ///< Brightness requested by the library user, never exceeded by the limiter
+        uint32_t _sum;          ///< Sum of the LUT corrected color bytes of the current frame
+} ws2812_power;
+#endif
+
 void _ws2812_get_rgbmap(uint8_t (*rgbmap)[3], ws2812_order order);
\ No newline at end of file
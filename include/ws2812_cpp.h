@@ -23,7 +23,8 @@
  * 
  * @brief C++ Wrapper for the Tiny-WS2812 interface
  * 
- * The following file defines a C++ wrapper for the Tiny-WS2812 interface
+ * The following file defines a C++ wrapper for the Tiny-WS2812 interface,
+ * as well as a compile-time specialized driver for AVR platforms (@ref ws2812_static).
  */
 
 #ifdef __cplusplus
@@ -34,6 +35,71 @@ extern "C" {
 
 }
 
+/**
+ * @brief Expands a 16 bit RGB565 value to a @ref ws2812_rgb "RGB value"
+ *
+ * The following function expands the 5, 6 and 5 bit channels of an RGB565 value to 8 bits
+ * by replicating their most significant bits into the low bits, such that full intensity
+ * is expanded to 255 rather than 248.
+ */
+static inline ws2812_rgb ws2812_expand_rgb565(uint16_t v)
+{
+        uint8_t r = (v >> 11) & 0x1F;
+        uint8_t g = (v >> 5) & 0x3F;
+        uint8_t b = v & 0x1F;
+
+        return { (uint8_t) ((r << 3) | (r >> 2)),
+                 (uint8_t) ((g << 2) | (g >> 4)),
+                 (uint8_t) ((b << 3) | (b >> 2)) };
+}
+
+/**
+ * @brief Expands an 8 bit RGB332 value to a @ref ws2812_rgb "RGB value"
+ *
+ * The following function expands the 3, 3 and 2 bit channels of an RGB332 value to 8 bits
+ * by replicating their bits into the low bits, such that full intensity is expanded to 255.
+ */
+static inline ws2812_rgb ws2812_expand_rgb332(uint8_t v)
+{
+        uint8_t r = v >> 5;
+        uint8_t g = (v >> 2) & 0x07;
+        uint8_t b = v & 0x03;
+
+        return { (uint8_t) ((r << 5) | (r << 2) | (r >> 1)),
+                 (uint8_t) ((g << 5) | (g << 2) | (g >> 1)),
+                 (uint8_t) (b * 0x55) };
+}
+
+/**
+ * @brief Iterator adapter to read a frame buffer of a compressed pixel format as RGB values
+ *
+ * The following class template wraps a pointer into a frame buffer of type T and
+ * expands the pointed to value through the provided function when dereferenced.
+ * Use the @ref ws2812_rgb565_iter and @ref ws2812_rgb332_iter typedefs rather
+ * than instantiating it directly.
+ */
+template <typename T, ws2812_rgb (*Expand)(T)>
+class _ws2812_fmt_iter {
+public:
+        explicit _ws2812_fmt_iter(const T *p) : _p(p) {}
+
+        ws2812_rgb operator*() const { return Expand(*_p); }
+        _ws2812_fmt_iter &operator++() { ++_p; return *this; }
+        _ws2812_fmt_iter operator+(size_t n) const { return _ws2812_fmt_iter(_p + n); }
+        ptrdiff_t operator-(const _ws2812_fmt_iter &other) const { return _p - other._p; }
+        bool operator==(const _ws2812_fmt_iter &other) const { return _p == other._p; }
+        bool operator!=(const _ws2812_fmt_iter &other) const { return _p != other._p; }
+
+private:
+        const T *_p; ///< Current position in the frame buffer
+};
+
+/// Iterator over a 16 bit RGB565 frame buffer (ex. `ws2812_rgb565_iter(fb)`)
+typedef _ws2812_fmt_iter<uint16_t, ws2812_expand_rgb565> ws2812_rgb565_iter;
+
+/// Iterator over an 8 bit RGB332 frame buffer (ex. `ws2812_rgb332_iter(fb)`)
+typedef _ws2812_fmt_iter<uint8_t, ws2812_expand_rgb332> ws2812_rgb332_iter;
+
 /**
  * @brief A C++ wrapper for the Tiny-WS2812 interface
  *
@@ -70,6 +136,41 @@ public:
          *
          */
         void tx(ws2812_rgb *leds, size_t n_leds);
+
+        /**
+         * @brief Transmits the RGB values of an iterator range through the ws2812_tx() function
+         *
+         * The following function transmits the RGB values in the range [first, last), where
+         * dereferencing an iterator must yield a @ref ws2812_rgb "RGB value" and last - first
+         * must yield the length of the range. Frame buffers of compressed pixel formats can
+         * thus be transmitted without expanding them first, through the @ref ws2812_rgb565_iter
+         * and @ref ws2812_rgb332_iter adapters (ex. `tx(ws2812_rgb565_iter(fb), ws2812_rgb565_iter(fb + n))`).
+         *
+         * The values are expanded inline into a small buffer on the stack, which is transmitted
+         * through one ws2812_tx() call every 8 LEDs. The data line idles low while the next 8 values
+         * are expanded, thus the timing constraints of ws2812_tx_gen() apply to 8 dereferences of the iterator.
+         */
+        template <typename Iterator>
+        void tx(Iterator first, Iterator last)
+        {
+                ws2812_rgb buf[_batch];
+
+                for (size_t n = last - first; n > 0;) {
+                        size_t k = n < _batch ? n : _batch;
+
+                        for (size_t i = 0; i < k; i++, ++first)
+                                buf[i] = *first;
+
+                        ws2812_tx(&_ws2812, buf, k);
+                        n -= k;
+                }
+        }
+
+        /**
+         * @brief Wraps around the ws2812_tx_layout() function
+         *
+         */
+        void tx(const ws2812_layout *layout, const ws2812_rgb *leds);
         
         
         /**
@@ -84,6 +185,327 @@ public:
          *
          */
         void close_tx();
+
+private:
+        // Number of LEDs expanded ahead of every ws2812_tx() call by tx(first, last)
+        static constexpr size_t _batch = 8;
+};
+
+#if defined(WS2812_TARGET_PLATFORM_AVR) || defined(WS2812_TARGET_PLATFORM_ARDUINO_AVR)
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+/// Tag type to select between the OUT and ST based transmit loops of @ref ws2812_static
+template <bool B> struct _ws2812_bool {};
+
+// NOP sequence of n cycles, where n is split into 2 cycle (nh) and 1 cycle (nl) operands
+#define _WS2812_STATIC_NOPS(n) \
+        "       .rept %[" n "h]       \n\t" \
+        "       rjmp  .+0             \n\t" \
+        "       .endr                 \n\t" \
+        "       .rept %[" n "l]       \n\t" \
+        "       nop                   \n\t" \
+        "       .endr                 \n\t"
+
+// Inner loop to transmit the byte held in %[byte], MSB first, using the provided
+// store instruction (ex. "out %i[port]," or "st X,")
+#define _WS2812_STATIC_TXBYTE(label, store) \
+        "       ldi   %[ctr],8        \n\t" \
+        label "%=:                    \n\t" \
+        "       " store "%[hi]        \n\t"    /* re      */ \
+        _WS2812_STATIC_NOPS("w1") \
+        "       sbrs  %[byte],7       \n\t" \
+        "       " store "%[lo]        \n\t"    /* fe-low  */ \
+        "       lsl   %[byte]         \n\t" \
+        _WS2812_STATIC_NOPS("w2") \
+        "       brcc  " label "skip%= \n\t" \
+        "       " store "%[lo]        \n\t"    /* fe-high */ \
+        label "skip%=:                \n\t" \
+        _WS2812_STATIC_NOPS("w3") \
+        "       dec   %[ctr]          \n\t" \
+        "       brne  " label "%=     \n\t"
+
+/**
+ * @brief A compile-time specialized WS2812 driver for AVR platforms
+ *
+ * Unlike the @ref ws2812_cpp "C++ wrapper", which forwards every call to the C interface,
+ * the following class template resolves the port, the pin mask, the color order and the
+ * timing of the WS2812 protocol at compile time. The resulting transmit loop is fully inlined:
+ * - The color order is resolved through constant displacements (`ldd`), rather
+ *   than through a runtime RGB map.
+ * - Ports within the I/O space (ex. PORTB on most AVRs) are written with the 1 cycle
+ *   `out` instruction, thus not occupying the X register.
+ * - The NOP counts are derived from the provided CPU clock.
+ *
+ * Example:
+ * @code
+ * ws2812_static<_SFR_MEM_ADDR(PORTB), _BV(PB0) | _BV(PB1), grb> ws2812_dev;
+ * @endcode
+ *
+ * @tparam Port Memory address of the PORT register (ex. `_SFR_MEM_ADDR(PORTB)`)
+ * @tparam PinMask Mask of the data pins on the PORT register
+ * @tparam Order Color order of the WS2812 device(s)
+ * @tparam RstUs Time required for the WS2812 device(s) to reset in us
+ * @tparam FCpu CPU clock in Hz
+ * @tparam Ddr Memory address of the Data Direction Register (defaults to the register below the PORT register)
+ *
+ * @note Only one ws2812_static object should exist per PORT and pin mask, as the class
+ *      holds no state apart from the stashed SREG.
+ */
+template <uint16_t Port, uint8_t PinMask, ws2812_order Order, uint16_t RstUs = WS2812_RST_US,
+          uint32_t FCpu = F_CPU, uint16_t Ddr = Port - 1>
+class ws2812_static {
+private:
+        // Timing in ns, unless a timing profile has been selected (see ws2812_common.h)
+#ifdef WS2812_T0H_NS
+        static constexpr int32_t zeropulse = WS2812_T0H_NS;
+        static constexpr int32_t onepulse = WS2812_T1H_NS;
+        static constexpr int32_t totalperiod = WS2812_PERIOD_NS;
+        static constexpr int32_t lowmax = WS2812_T0H_MAX_NS;
+        static constexpr int32_t highmin = WS2812_T1H_MIN_NS;
+#else
+        static constexpr int32_t zeropulse = 350;
+        static constexpr int32_t onepulse = 900;
+        static constexpr int32_t totalperiod = 1250;
+        static constexpr int32_t lowmax = 550;
+        static constexpr int32_t highmin = 625;
+#endif
+
+        // Ports in the I/O space can be written through OUT
+        static constexpr bool io = Port >= __SFR_OFFSET && Port < __SFR_OFFSET + 0x40;
+
+        // Fixed cycles used by the inner loop
+        static constexpr int32_t fixedlow = io ? 2 : 3;
+        static constexpr int32_t fixedhigh = io ? 5 : 6;
+        static constexpr int32_t fixedtotal = io ? 8 : 10;
+
+        static constexpr int32_t zerocycles = ((FCpu/1000)*zeropulse)/1000000;
+        static constexpr int32_t onecycles = ((FCpu/1000)*onepulse + 500000)/1000000;
+        static constexpr int32_t totalcycles = ((FCpu/1000)*totalperiod + 500000)/1000000;
+
+        static constexpr int32_t clamp(int32_t n) { return n > 0 ? n : 0; }
+
+        // w1 - nops between rising edge and falling edge - low
+        static constexpr int32_t w1 = clamp(zerocycles - fixedlow);
+        // w2 - nops between fe low and fe high
+        static constexpr int32_t w2 = clamp(onecycles - fixedhigh - w1);
+        // w3 - nops to complete loop
+        static constexpr int32_t w3 = clamp(totalcycles - fixedtotal - w1 - w2);
+
+        // The only critical timing parameter is the minimum pulse length of the "0"
+        static constexpr int32_t lowtime = ((w1 + fixedlow)*1000000)/(FCpu/1000);
+        static_assert(lowtime <= lowmax, "ws2812_static: Sorry, the clock speed is too low. Did you set F_CPU correctly?");
+
+        // Pulse length of the "1" and bit period resulting from the NOPs, as checked by the C driver
+        static constexpr int32_t hightime = ((w1 + w2 + fixedhigh)*1000000)/(FCpu/1000);
+        static constexpr int32_t periodtime = ((w1 + w2 + w3 + fixedtotal)*1000000)/(FCpu/1000);
+        static_assert(hightime >= highmin, "ws2812_static: The pulse length of the \"1\" is too short. Please check the fixed cycles of the inner loop.");
+        static_assert(periodtime >= totalperiod - 100, "ws2812_static: The bit period is too short. Please check the fixed cycles of the inner loop.");
+
+        /**
+         * @brief Returns the offset of the j-th transmitted byte within a ws2812_rgb struct
+         */
+        static constexpr uint8_t offset(uint8_t j)
+        {
+                return Order == rbg ? (j == 0 ? 0 : j == 1 ? 2 : 1) :
+                       Order == brg ? (j == 0 ? 2 : j == 1 ? 0 : 1) :
+                       Order == bgr ? (j == 0 ? 2 : j == 1 ? 1 : 0) :
+                       Order == grb ? (j == 0 ? 1 : j == 1 ? 0 : 2) :
+                       Order == gbr ? (j == 0 ? 1 : j == 1 ? 2 : 0) :
+                                      j; // rgb
+        }
+
+        uint8_t _sreg_prev; ///< SREG stashed by prep_tx()
+        bool _prep;         ///< Flag to indicate if a transmission has been prepared
+
+        /**
+         * @brief Transmits the frame through OUT instructions
+         */
+        static inline void tx_frame(ws2812_rgb *leds, size_t n_leds, uint8_t hi, uint8_t lo, _ws2812_bool<true>)
+        {
+                uint8_t ctr;
+                uint8_t byte;
+
+                asm volatile(
+                        "pxl%=:                      \n\t"
+                        "       ldd   %[byte],Z+%[o0] \n\t"
+                        _WS2812_STATIC_TXBYTE("b0_", "out   %i[port],")
+                        "       ldd   %[byte],Z+%[o1] \n\t"
+                        _WS2812_STATIC_TXBYTE("b1_", "out   %i[port],")
+                        "       ldd   %[byte],Z+%[o2] \n\t"
+                        _WS2812_STATIC_TXBYTE("b2_", "out   %i[port],")
+                        "       adiw  %[z],3          \n\t"    // Advance to next pixel
+                        "       sbiw  %[n],1          \n\t"    // Decrement remaining pixels
+                        "       brne  pxl%=           \n\t"
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "+z" (leds), [n] "+w" (n_leds)
+                        :	[port] "n" (Port), [hi] "r" (hi), [lo] "r" (lo),
+                                [o0] "I" (offset(0)), [o1] "I" (offset(1)), [o2] "I" (offset(2)),
+                                [w1h] "n" (w1/2), [w1l] "n" (w1&1), [w2h] "n" (w2/2), [w2l] "n" (w2&1),
+                                [w3h] "n" (w3/2), [w3l] "n" (w3&1)
+                        :	"memory"
+                );
+        }
+
+        /**
+         * @brief Transmits the frame through ST instructions
+         */
+        static inline void tx_frame(ws2812_rgb *leds, size_t n_leds, uint8_t hi, uint8_t lo, _ws2812_bool<false>)
+        {
+                uint8_t ctr;
+                uint8_t byte;
+
+                asm volatile(
+                        "pxl%=:                      \n\t"
+                        "       ldd   %[byte],Z+%[o0] \n\t"
+                        _WS2812_STATIC_TXBYTE("b0_", "st    X,")
+                        "       ldd   %[byte],Z+%[o1] \n\t"
+                        _WS2812_STATIC_TXBYTE("b1_", "st    X,")
+                        "       ldd   %[byte],Z+%[o2] \n\t"
+                        _WS2812_STATIC_TXBYTE("b2_", "st    X,")
+                        "       adiw  %[z],3          \n\t"    // Advance to next pixel
+                        "       sbiw  %[n],1          \n\t"    // Decrement remaining pixels
+                        "       brne  pxl%=           \n\t"
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "+z" (leds), [n] "+w" (n_leds)
+                        :	"x" ((volatile uint8_t *) Port), [hi] "r" (hi), [lo] "r" (lo),
+                                [o0] "I" (offset(0)), [o1] "I" (offset(1)), [o2] "I" (offset(2)),
+                                [w1h] "n" (w1/2), [w1l] "n" (w1&1), [w2h] "n" (w2/2), [w2l] "n" (w2&1),
+                                [w3h] "n" (w3/2), [w3l] "n" (w3&1)
+                        :	"memory"
+                );
+        }
+
+        /**
+         * @brief Transmits a single RGB value through OUT instructions
+         */
+        static inline void tx_pxl(ws2812_rgb pxl, uint8_t hi, uint8_t lo, _ws2812_bool<true>)
+        {
+                const uint8_t *v = (const uint8_t *) &pxl;
+                uint8_t ctr;
+                uint8_t byte;
+
+                asm volatile(
+                        "       mov   %[byte],%[v0]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b0_", "out   %i[port],")
+                        "       mov   %[byte],%[v1]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b1_", "out   %i[port],")
+                        "       mov   %[byte],%[v2]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b2_", "out   %i[port],")
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte)
+                        :	[port] "n" (Port), [hi] "r" (hi), [lo] "r" (lo),
+                                [v0] "r" (v[offset(0)]), [v1] "r" (v[offset(1)]), [v2] "r" (v[offset(2)]),
+                                [w1h] "n" (w1/2), [w1l] "n" (w1&1), [w2h] "n" (w2/2), [w2l] "n" (w2&1),
+                                [w3h] "n" (w3/2), [w3l] "n" (w3&1)
+                        :	"memory"
+                );
+        }
+
+        /**
+         * @brief Transmits a single RGB value through ST instructions
+         */
+        static inline void tx_pxl(ws2812_rgb pxl, uint8_t hi, uint8_t lo, _ws2812_bool<false>)
+        {
+                const uint8_t *v = (const uint8_t *) &pxl;
+                uint8_t ctr;
+                uint8_t byte;
+
+                asm volatile(
+                        "       mov   %[byte],%[v0]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b0_", "st    X,")
+                        "       mov   %[byte],%[v1]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b1_", "st    X,")
+                        "       mov   %[byte],%[v2]   \n\t"
+                        _WS2812_STATIC_TXBYTE("b2_", "st    X,")
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte)
+                        :	"x" ((volatile uint8_t *) Port), [hi] "r" (hi), [lo] "r" (lo),
+                                [v0] "r" (v[offset(0)]), [v1] "r" (v[offset(1)]), [v2] "r" (v[offset(2)]),
+                                [w1h] "n" (w1/2), [w1l] "n" (w1&1), [w2h] "n" (w2/2), [w2l] "n" (w2&1),
+                                [w3h] "n" (w3/2), [w3l] "n" (w3&1)
+                        :	"memory"
+                );
+        }
+
+public:
+        /**
+         * @brief Constructs a @ref ws2812_static object and configures the data pins as outputs
+         */
+        ws2812_static() : _prep(false)
+        {
+                *((volatile uint8_t *) Ddr) |= PinMask;
+        }
+
+        /**
+         * @brief Equivalent of the ws2812_prep_tx() function
+         */
+        inline void prep_tx()
+        {
+                if (!_prep) {
+                        _sreg_prev = SREG;
+                        _prep = true;
+                }
+        }
+
+        /**
+         * @brief Equivalent of the ws2812_tx() function
+         */
+        inline void tx(ws2812_rgb *leds, size_t n_leds)
+        {
+                if (n_leds == 0)
+                        return;
+
+                uint8_t sreg = SREG;
+                cli();
+                uint8_t lo = *((volatile uint8_t *) Port) & ~PinMask;
+                tx_frame(leds, n_leds, lo | PinMask, lo, _ws2812_bool<io>());
+                SREG = sreg;
+        }
+
+        /**
+         * @brief Equivalent of the ws2812_cpp::tx(Iterator, Iterator) function
+         *
+         * Unlike the @ref ws2812_cpp "C++ wrapper", the values are expanded one at a time, inline
+         * between the transmit loops of two LEDs, thus the data line only idles low for as long as
+         * a single dereference and increment of the iterator.
+         */
+        template <typename Iterator>
+        inline void tx(Iterator first, Iterator last)
+        {
+                if (first == last)
+                        return;
+
+                uint8_t sreg = SREG;
+                cli();
+                uint8_t lo = *((volatile uint8_t *) Port) & ~PinMask;
+                for (; first != last; ++first)
+                        tx_pxl(*first, lo | PinMask, lo, _ws2812_bool<io>());
+                SREG = sreg;
+        }
+
+        /**
+         * @brief Equivalent of the ws2812_wait_rst() function
+         */
+        inline void wait_rst()
+        {
+                _delay_us(RstUs);
+        }
+
+        /**
+         * @brief Equivalent of the ws2812_close_tx() function
+         */
+        inline void close_tx()
+        {
+                if (_prep) {
+                        SREG = _sreg_prev;
+                        _prep = false;
+                        wait_rst();
+                }
+        }
 };
 
+#undef _WS2812_STATIC_TXBYTE
+#undef _WS2812_STATIC_NOPS
+
+#endif
+
 #endif // __cplusplus
\ No newline at end of file
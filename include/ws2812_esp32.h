@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_esp32.h
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Provides ESP32 (RMT) platform specific definitions.
+ *
+ */
+
+#pragma once
+
+#ifdef WS2812_TARGET_PLATFORM_ESP32
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <driver/rmt.h>
+
+#include "ws2812_common.h"
+
+/// Size in bytes of the bitstream of n_pxls LEDs, encoded by ws2812_encode() (8 RMT items per color byte)
+#define WS2812_ENCODED_SIZE(n_pxls) ((n_pxls) * sizeof(ws2812_rgb) * 8 * sizeof(rmt_item32_t))
+
+/*
+ * ESP32: Data structure to configure a @ref ws2812 "WS2812 device struct" on ESP32 platforms.
+ *
+ * The following struct is used to initialize/configure a @ref ws2812 "WS2812 device struct"
+ * on ESP32 based devices, where the WS2812 device(s) are driven by an RMT channel. It is passed
+ * to the ws2812_config() function along with a reference to a @ref ws2812 "WS2812 device struct",
+ * and contains relevant information such as the RMT channel and pins used to drive WS2812 devices,
+ * the device's reset time etc.
+ *
+ * All pins of a configuration output the same waveform. To drive different frames in parallel,
+ * configure one @ref ws2812 "WS2812 device struct" per RMT channel.
+ *
+ * NOTE: The library makes use of the RMT driver of the ESP-IDF (driver/rmt.h), which is
+ * available on ESP-IDF v4.3 and later, as well as on the Arduino ESP32 core.
+ *
+ * WARNING: All fields of the configuration object must be defined before passing it to #ws2812_config()!
+ *      Leaving a field undefined will result in undefined behaivor!
+ */
+typedef struct ws2812_cfg {
+        rmt_channel_t channel;  ///< RMT channel used to drive the WS2812 device(s) (ex. RMT_CHANNEL_0), must not be used elsewhere
+        uint8_t *pins;          ///< Array of GPIOs used to program WS2812 devices
+        uint16_t rst_time_us;   ///< Time required for the WS2812 device(s) to reset in us
+        ws2812_order order;     ///< Color order of the WS2812 device(s) (ex. rgb, grb, bgr...)
+        uint8_t n_dev;          ///< Number of WS2812 device to drive
+} ws2812_cfg;
+
+/*
+ * ESP32: WS2812 device struct to drive one or more WS2812 devices through an RMT channel.
+ *
+ * The following struct is used to drive one or more WS2812 devices on ESP32 based devices
+ * through an RMT channel. It is initialized by the ws2812_config() function and is taken
+ * as an argument by practically every function of the TinyWS2812 library relevant to driving
+ * WS2812 devices (ex. ws2812_tx(), ws2812_prep_tx(), etc...).
+ *
+ * The src_ fields describe the data currently being translated into RMT items by the
+ * RMT interrupt, and must not be accessed by the library user.
+ *
+ * See ws2812_config()
+ *
+ */
+typedef struct ws2812 {
+        rmt_channel_t channel;  ///< RMT channel used to drive the WS2812 device(s)
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
+        uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
+        uint8_t src_type;       ///< Type of the data being transmitted (pixels, raw bytes, fill, runs, indices or generated)
+        const void *src;        ///< Data being transmitted
+        size_t src_size;        ///< Number of color bytes being transmitted
+        const ws2812_rgb *src_palette; ///< Palette of an indexed transmission
+        uint8_t src_bits;       ///< Bits per index of an indexed transmission
+        ws2812_rgb src_color;   ///< Color of a fill transmission, or the last value of a generated transmission
+        size_t src_run;         ///< Current run of a run-length encoded transmission, or the next LED to be generated
+        size_t src_run_end;     ///< Index of the pixel following the current run
+        ws2812_rgb (*src_gen)(size_t idx, void *ctx); ///< Generator callback of a generated transmission
+        void *src_ctx;          ///< User pointer passed on to the generator callback
+} ws2812;
+
+/**
+ * @brief ESP32: Transmits RGB values to the provided @ref ws2812 "WS2812 device" in the background.
+ *
+ * The following function starts a transmission of RGB values on the RMT channel of the device and
+ * returns immediately. The RGB values are translated into RMT items by the RMT interrupt, half a
+ * RMT memory block at a time, thus the CPU is only occupied for a fraction of the transmission.
+ * Devices configured on different RMT channels may transmit in parallel. Only one background
+ * transmission can be in progress per device, hence the function waits for an ongoing one to
+ * finish first.
+ *
+ * Just as for #ws2812_tx(), the transmission must be embedded between #ws2812_prep_tx()
+ * and #ws2812_close_tx(), where #ws2812_close_tx() waits for the background transmission
+ * to finish.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param pxls RGB values to be transmitted, which must not be altered until #ws2812_tx_done() returns true
+ * @param n_pxls Number of RGB values to be transmitted
+ */
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief ESP32: Indicates whether a background transmission has finished.
+ *
+ * The following function returns true once all RGB values passed to #ws2812_tx_async()
+ * (or the bitstream passed to #ws2812_tx_encoded())
+ * have been shifted out, after which the RGB array (or bitstream) may be altered again.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" of the background transmission
+ */
+bool ws2812_tx_done(ws2812 *dev);
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_rp2040.h
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Provides RP2040 (PIO) platform specific definitions.
+ *
+ */
+
+#pragma once
+
+#ifdef WS2812_TARGET_PLATFORM_RP2040
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <hardware/pio.h>
+
+#include "ws2812_common.h"
+
+/// Size in bytes of the bitstream of n_pxls LEDs, encoded by ws2812_encode() (8 bit slices per color byte)
+#define WS2812_ENCODED_SIZE(n_pxls) ((n_pxls) * sizeof(ws2812_rgb) * 8)
+
+/*
+ * RP2040: Data structure to configure a @ref ws2812 "WS2812 device struct" on RP2040 platforms.
+ *
+ * The following struct is used to initialize/configure a @ref ws2812 "WS2812 device struct"
+ * on RP2040 based devices, where the WS2812 device(s) are driven by a PIO state machine. It is
+ * passed to the ws2812_config() function along with a reference to a @ref ws2812 "WS2812 device struct",
+ * and contains relevant information such as the PIO block and pins used to drive WS2812 devices,
+ * the device's reset time etc.
+ *
+ * Every configured device claims one state machine of the provided PIO block. Devices with a
+ * single pin additionally claim a DMA channel, through which ws2812_tx_async() feeds the state
+ * machine. Devices with multiple pins are fed bit sliced by the CPU, so that every pin may
+ * be programmed with its own RGB values through ws2812_tx_parallel(). GPIOs that lie between the
+ * pins of such a device must not be used by other devices on the same PIO block.
+ *
+ * The DMA channel reads the color bytes as they are to be transmitted. Unless the device is
+ * in rgb order and neither a LUT nor a brightness are set, ws2812_tx_async() thus swizzles
+ * the frame into the staging buffer once, or transmits it through the CPU if no sufficiently
+ * large staging buffer has been provided.
+ *
+ * NOTE: The library makes use of the Raspberry Pi Pico SDK (hardware_pio, hardware_dma and
+ * hardware_clocks), meaning it is a required dependency to use this library.
+ *
+ * WARNING: All fields of the configuration object must be defined before passing it to #ws2812_config()!
+ *      Leaving a field undefined will result in undefined behaivor!
+ */
+typedef struct ws2812_cfg {
+        PIO pio;                ///< PIO block used to drive the WS2812 device(s) (ex. pio0, pio1)
+        uint8_t *pins;          ///< Array of GPIOs used to program WS2812 devices (**Must lie within 8 consecutive GPIOs!** (ex. GPIO 2-9))
+        uint16_t rst_time_us;   ///< Time required for the WS2812 device(s) to reset in us
+        ws2812_order order;     ///< Color order of the WS2812 device(s) (ex. rgb, grb, bgr...)
+        uint8_t n_dev;          ///< Number of WS2812 device to drive
+        uint8_t *buf;           ///< Staging buffer for DMA transmissions (NULL = none)
+        size_t buf_size;        ///< Size of the staging buffer in bytes (3 bytes per RGB value)
+} ws2812_cfg;
+
+/*
+ * RP2040: WS2812 device struct to drive one or more WS2812 devices through a PIO state machine.
+ *
+ * The following struct is used to drive one or more WS2812 devices on RP2040 based devices
+ * through a PIO state machine. It is initialized by the ws2812_config() function and is taken
+ * as an argument by practically every function of the TinyWS2812 library relevant to driving
+ * WS2812 devices (ex. ws2812_tx(), ws2812_prep_tx(), etc...).
+ *
+ * See ws2812_config()
+ *
+ */
+typedef struct ws2812 {
+        PIO pio;                ///< PIO block of the state machine
+        uint8_t sm;             ///< State machine driving the WS2812 device(s)
+        int8_t dma;             ///< DMA channel feeding the state machine (-1 for devices with multiple pins)
+        uint8_t pin_msk;        ///< Mask of the pins relative to the lowest pin
+        uint8_t *buf;           ///< Staging buffer for DMA transmissions
+        size_t buf_size;        ///< Size of the staging buffer in bytes
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
+        uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
+} ws2812;
+
+/**
+ * @brief RP2040: Transmits RGB values to the provided @ref ws2812 "WS2812 device" in the background.
+ *
+ * The following function starts a DMA transfer of RGB values into the TX FIFO of the state machine
+ * of the device and returns immediately, thus neither the CPU nor interrupts are involved in the
+ * transmission. Devices on different state machines may transmit in parallel. Only one background
+ * transmission can be in progress per device, hence the function waits for an ongoing one to finish first.
+ *
+ * If the color order or correction (LUT and brightness) of the device requires the frame to be altered,
+ * it is swizzled into the staging buffer of the device once before the transfer is started. If the
+ * staging buffer is too small, or if the device drives multiple pins, the frame is transmitted through
+ * the CPU and the function only returns once it has been handed to the state machine.
+ *
+ * Just as for #ws2812_tx(), the transmission must be embedded between #ws2812_prep_tx()
+ * and #ws2812_close_tx(), where #ws2812_close_tx() waits for the background transmission
+ * to finish.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param pxls RGB values to be transmitted, which must not be altered until #ws2812_tx_done() returns true
+ * @param n_pxls Number of RGB values to be transmitted
+ */
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief RP2040: Indicates whether a background transmission has finished.
+ *
+ * The following function returns true once all RGB values passed to #ws2812_tx_async()
+ * (or the bitstream passed to #ws2812_tx_encoded())
+ * have been handed to the state machine, after which the RGB array (or bitstream) may be altered again.
+ * The last few bytes may still be in the TX FIFO, #ws2812_close_tx() waits for them to be shifted out.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" of the background transmission
+ */
+bool ws2812_tx_done(ws2812 *dev);
+
+#endif
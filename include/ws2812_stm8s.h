@@ -31,6 +31,7 @@
 
 #include <stm8s.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "ws2812_common.h"
 
@@ -68,7 +69,7 @@
 typedef struct ws2812_cfg {
 	uint16_t port_baseaddr; ///< Base address of the port used to drive WS2812 devices (ex. GPIOA_BASE, GPIOB_BASE, etc...)
         GPIO_Pin_TypeDef *pins; ///< Array of pins used to drive WS2812 devices (ex. GPIO_PIN_1, GPIO_PIN_2, etc...)
-        uint8_t rst_time_us;    ///< Time required for the WS2812 device(s) to reset in us
+        uint16_t rst_time_us;   ///< Time required for the WS2812 device(s) to reset in us
         ws2812_order order;     ///< Color order of the WS2812 device(s) (ex. rgb, grb, bgr...)
         uint8_t n_dev;          ///< Number of WS2812 devices to drive
 } ws2812_cfg;
@@ -100,10 +101,26 @@ typedef struct ws2812_cfg {
  */
 typedef struct ws2812 {
         uint16_t port_baseaddr; ///< Base address of the port used to drive WS2812 devices (ex. GPIOA_BASE, GPIOB_BASE, etc...)
-        uint8_t rst_time_us;    ///< Time required for WS2812 to reset in us
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
         uint8_t maskhi;         ///< PORT masks to toggle the data pins high.
         uint8_t masklo;         ///< PORT masks to toggle the data pins low.
         uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        ws2812_irq irq;         ///< Interrupt policy of the device
+        uint8_t irq_pxls;       ///< Number of LEDs between two interrupt windows (ws2812_irq_pxls)
+        uint8_t irq_cc;         ///< CC register of the caller of ws2812_prep_tx(), whose interrupt level is restored by ws2812_close_tx() (ws2812_irq_frame)
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
 } ws2812;
 
 #endif
\ No newline at end of file
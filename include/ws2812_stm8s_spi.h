@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_stm8s_spi.h
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Provides STM8S SPI platform specific definitions.
+ *
+ */
+
+#pragma once
+
+#ifdef WS2812_TARGET_PLATFORM_STM8S_SPI
+
+#include <stm8s.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ws2812_common.h"
+
+/// Size in bytes of the bitstream of n_pxls LEDs, encoded by ws2812_encode() (4 SPI bytes per color byte)
+#define WS2812_ENCODED_SIZE(n_pxls) ((n_pxls) * sizeof(ws2812_rgb) * 4)
+
+/*
+ * STM8S SPI: Data structure to configure a @ref ws2812 "WS2812 device struct" on STM8S platforms,
+ * driven by the SPI peripheral.
+ *
+ * The following struct is used to initialize/configure a @ref ws2812 "WS2812 device struct"
+ * on STM8S based devices, where the WS2812 device(s) are driven by the MOSI pin (PC6) of the
+ * SPI peripheral. It is passed to the ws2812_config() function along with a reference to a
+ * @ref ws2812 "WS2812 device struct", and contains relevant information such as the device's
+ * reset time etc.
+ *
+ * As the bits are shifted out by the SPI peripheral, only one data line (MOSI) is available.
+ * Multiple WS2812 devices may still be driven in parallel by wiring them to the same pin.
+ *
+ * NOTE: The library currently makes use of the STM8 Standard Peripheral Library meaning it is
+ * a required dependency to use this library.
+ *
+ * WARNING: All fields of the configuration object must be defined before passing it to #ws2812_config()!
+ *      Leaving a field undefined will result in undefined behaivor!
+ */
+typedef struct ws2812_cfg {
+        uint16_t rst_time_us;   ///< Time required for the WS2812 device(s) to reset in us
+        ws2812_order order;     ///< Color order of the WS2812 device(s) (ex. rgb, grb, bgr...)
+} ws2812_cfg;
+
+/*
+ * STM8S SPI: WS2812 device struct to drive one or more WS2812 devices through the SPI peripheral.
+ *
+ * The following struct is used to drive one or more WS2812 devices on STM8S based devices
+ * through the SPI peripheral. It is initialized by the ws2812_config() function and is taken
+ * as an argument by practically every function of the TinyWS2812 library relevant to driving
+ * WS2812 devices (ex. ws2812_tx(), ws2812_prep_tx(), etc...).
+ *
+ * See ws2812_config()
+ *
+ */
+typedef struct ws2812 {
+        uint16_t rst_time_us;   ///< Time required for WS2812 to reset in us
+        uint8_t rgbmap[3];      ///< RGB map to map/convert RGB values to another color order
+        uint8_t brightness;     ///< Brightness by which all colors are scaled (255 = unscaled)
+        const uint8_t *lut;     ///< LUT through which all colors are translated (NULL = none)
+        uint16_t (*now_us)(void); ///< Free running microsecond timer to track the reset (NULL = busy wait)
+#ifdef WS2812_STATS
+        ws2812_stats *stats;    ///< Statistics of the transmitted frames (NULL = none)
+#endif
+#ifdef WS2812_POWER
+        ws2812_power *power;    ///< Current budget of the WS2812 device(s) (NULL = unlimited)
+        uint8_t n_pins;         ///< Number of data pins, all of which draw the current of the transmitted colors
+#endif
+        uint16_t rst_start;     ///< Timestamp at which the last transmission was closed
+        bool rst_pending;       ///< Flag to indicate if the reset of the last transmission may not have elapsed yet
+        bool prep;              ///< Flag to indicate if the device has been prepared for transmission
+} ws2812;
+
+/**
+ * @brief STM8S SPI: Transmits RGB values to the provided @ref ws2812 "WS2812 device" in the background.
+ *
+ * The following function starts an interrupt driven transmission of RGB values and returns
+ * immediately, so that the main loop may keep running while the frame is being shifted out.
+ * Every time the SPI transmit buffer runs empty, #ws2812_spi_isr() refills it with the next
+ * encoded byte. Only one background transmission can be in progress at a time, hence
+ * the function waits for an ongoing one to finish first.
+ *
+ * Just as for #ws2812_tx(), the transmission must be embedded between #ws2812_prep_tx()
+ * and #ws2812_close_tx(), where #ws2812_close_tx() waits for the background transmission
+ * to finish. Interrupts must be enabled for the transmission to progress.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" to be programmed
+ * @param pxls RGB values to be transmitted, which must not be altered until #ws2812_tx_done() returns true
+ * @param n_pxls Number of RGB values to be transmitted
+ */
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls);
+
+/**
+ * @brief STM8S SPI: Indicates whether a background transmission has finished.
+ *
+ * The following function returns true once all RGB values passed to #ws2812_tx_async()
+ * (or the bitstream passed to #ws2812_tx_encoded())
+ * have been handed to the SPI peripheral, after which the RGB array (or bitstream) may be altered again.
+ *
+ * @param dev @ref ws2812 "WS2812 device struct" of the background transmission
+ */
+bool ws2812_tx_done(ws2812 *dev);
+
+/**
+ * @brief STM8S SPI: SPI interrupt handler of the background transmission.
+ *
+ * The following function must be called from the SPI interrupt handler for
+ * #ws2812_tx_async() to work, ex. in stm8s_it.c:
+ *
+ * @code
+ * INTERRUPT_HANDLER(SPI_IRQHandler, 10)
+ * {
+ *         ws2812_spi_isr();
+ * }
+ * @endcode
+ */
+void ws2812_spi_isr(void);
+
+#endif
@@ -34,6 +34,7 @@
 
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
 #include <ws2812.h>
@@ -42,54 +43,83 @@
 #include <Arduino.h>
 #endif
 
-// Timing in ns
+// Timing in ns, unless a timing profile has been selected (see ws2812_common.h)
+#ifdef WS2812_T0H_NS
+#define w_zeropulse   WS2812_T0H_NS
+#define w_onepulse    WS2812_T1H_NS
+#define w_totalperiod WS2812_PERIOD_NS
+#else
 #define w_zeropulse   350
 #define w_onepulse    900
 #define w_totalperiod 1250
+#endif
 
 // Fixed cycles used by the inner loop
+#ifdef WS2812_AVR_IO_PORT
+#define w_fixedlow    2
+#define w_fixedhigh   5
+#define w_fixedtotal  8
+#else
 #define w_fixedlow    3
 #define w_fixedhigh   6
 #define w_fixedtotal  10   
+#endif
 
 // Insert NOPs to match the timing, if possible
 #define w_zerocycles    (((F_CPU/1000)*w_zeropulse          )/1000000)
 #define w_onecycles     (((F_CPU/1000)*w_onepulse    +500000)/1000000)
 #define w_totalcycles   (((F_CPU/1000)*w_totalperiod +500000)/1000000)
 
+// The cycle counts are unsigned, hence they are compared before being subtracted
 // w1 - nops between rising edge and falling edge - low
-#define w1 (w_zerocycles-w_fixedlow)
+#if w_zerocycles>w_fixedlow
+  #define w1_nops (w_zerocycles-w_fixedlow)
+#else
+  #define w1_nops  0
+#endif
+
 // w2   nops between fe low and fe high
-#define w2 (w_onecycles-w_fixedhigh-w1)
-// w3   nops to complete loop
-#define w3 (w_totalcycles-w_fixedtotal-w1-w2)
+#if w_onecycles>w_fixedhigh+w1_nops
+#define w2_nops (w_onecycles-w_fixedhigh-w1_nops)
+#else
+#define w2_nops  0
+#endif
 
-#if w1>0
-  #define w1_nops w1
+// w3   nops to complete loop
+#if w_totalcycles>w_fixedtotal+w1_nops+w2_nops
+#define w3_nops (w_totalcycles-w_fixedtotal-w1_nops-w2_nops)
 #else
-  #define w1_nops  0
+#define w3_nops  0
 #endif
 
 // The only critical timing parameter is the minimum pulse length of the "0"
 // Warn or throw error if this timing can not be met with current F_CPU settings.
 #define w_lowtime ((w1_nops+w_fixedlow)*1000000)/(F_CPU/1000)
-#if w_lowtime>550
+#ifdef WS2812_T0H_MAX_NS
+  #if w_lowtime>WS2812_T0H_MAX_NS
+   #error "Light_ws2812: Sorry, the clock speed is too low for the selected timing profile."
+  #endif
+#elif w_lowtime>550
    #error "Light_ws2812: Sorry, the clock speed is too low. Did you set F_CPU correctly?"
 #elif w_lowtime>450
    #warning "Light_ws2812: The timing is critical and may only work on WS2812B, not on WS2812(S)."
    #warning "Please consider a higher clockspeed, if possible"
 #endif   
 
-#if w2>0
-#define w2_nops w2
+// Resulting pulse length of the "1" and bit period in ns. The "1" must stay clear of the
+// sampling point of the WS2812 (~625ns, or the shortest "1" of the timing profile), which guards the NOP math and the fixed cycles above
+// against changes to the inner loop.
+#define w_hightime   ((w1_nops+w2_nops+w_fixedhigh)*1000000)/(F_CPU/1000)
+#define w_periodtime ((w1_nops+w2_nops+w3_nops+w_fixedtotal)*1000000)/(F_CPU/1000)
+#ifdef WS2812_T1H_MIN_NS
+  #define w_highmin WS2812_T1H_MIN_NS
 #else
-#define w2_nops  0
+  #define w_highmin 625
 #endif
-
-#if w3>0
-#define w3_nops w3
-#else
-#define w3_nops  0
+#if w_hightime<w_highmin
+   #error "Light_ws2812: The pulse length of the \"1\" is too short. Please check the fixed cycles of the inner loop."
+#elif w_periodtime<w_totalperiod-100
+   #error "Light_ws2812: The bit period is too short. Please check the fixed cycles of the inner loop."
 #endif
 
 #define w_nop1  "nop      \n\t"
@@ -98,27 +128,146 @@
 #define w_nop8  w_nop4 w_nop4
 #define w_nop16 w_nop8 w_nop8
 
-static uint8_t _sreg_prev;
-static bool _prep = false;
+// NOP sequences of the inner loop, pieced together once so that
+// they can be shared by all transmit paths
+#if (w1_nops&1)
+#define w1_nop1 w_nop1
+#else
+#define w1_nop1
+#endif
+#if (w1_nops&2)
+#define w1_nop2 w_nop2
+#else
+#define w1_nop2
+#endif
+#if (w1_nops&4)
+#define w1_nop4 w_nop4
+#else
+#define w1_nop4
+#endif
+#if (w1_nops&8)
+#define w1_nop8 w_nop8
+#else
+#define w1_nop8
+#endif
+#if (w1_nops&16)
+#define w1_nop16 w_nop16
+#else
+#define w1_nop16
+#endif
+#if (w2_nops&1)
+#define w2_nop1 w_nop1
+#else
+#define w2_nop1
+#endif
+#if (w2_nops&2)
+#define w2_nop2 w_nop2
+#else
+#define w2_nop2
+#endif
+#if (w2_nops&4)
+#define w2_nop4 w_nop4
+#else
+#define w2_nop4
+#endif
+#if (w2_nops&8)
+#define w2_nop8 w_nop8
+#else
+#define w2_nop8
+#endif
+#if (w2_nops&16)
+#define w2_nop16 w_nop16
+#else
+#define w2_nop16
+#endif
+#if (w3_nops&1)
+#define w3_nop1 w_nop1
+#else
+#define w3_nop1
+#endif
+#if (w3_nops&2)
+#define w3_nop2 w_nop2
+#else
+#define w3_nop2
+#endif
+#if (w3_nops&4)
+#define w3_nop4 w_nop4
+#else
+#define w3_nop4
+#endif
+#if (w3_nops&8)
+#define w3_nop8 w_nop8
+#else
+#define w3_nop8
+#endif
+#if (w3_nops&16)
+#define w3_nop16 w_nop16
+#else
+#define w3_nop16
+#endif
+#define w1_nopseq w1_nop1 w1_nop2 w1_nop4 w1_nop8 w1_nop16
+#define w2_nopseq w2_nop1 w2_nop2 w2_nop4 w2_nop8 w2_nop16
+#define w3_nopseq w3_nop1 w3_nop2 w3_nop4 w3_nop8 w3_nop16
+
+/*
+ * Writes the provided register to the port.
+ *
+ * If the port is known at compile time through WS2812_AVR_IO_PORT (ex. PORTB or VPORTA_OUT),
+ * it is written through the 1 cycle `out` instruction. Otherwise it is written through the
+ * 2 cycle `st` instruction, which expects the port address in X. w_port provides the
+ * matching asm operand, which every transmit path with a port write must list as an input.
+ */
+#ifdef WS2812_AVR_IO_PORT
+#define w_st(reg)     "       out   %[port]," reg "   \n\t"
+#define w_port        [port] "I" (_SFR_IO_ADDR(WS2812_AVR_IO_PORT))
+#define w_nopio       w_nop1
+#else
+#define w_st(reg)     "       st    X," reg "         \n\t"
+#define w_port        "x" ((uint8_t *) dev->port)
+#define w_nopio
+#endif
+
+/*
+ * Inner loop to transmit the byte held in %[byte], MSB first.
+ *
+ * The loop is primarily based on the driver code of [cpldcpu's light_ws2812](https://github.com/cpldcpu/light_ws2812)
+ * library. It expects the port to be accessible through w_st(), a bit counter in %[ctr] (upper register)
+ * and the port masks in %[hi] and %[lo]. The label prefix must be unique within the
+ * asm statement it is used in. The cycle counts below refer to the `st` based port write.
+ */
+#define w_txbyte(label) \
+        "       ldi   %[ctr],8        \n\t" \
+        label "%=:                    \n\t" \
+        w_st("%[hi]")                          /*  '1' [02] '0' [02] - re      */ \
+        w1_nopseq \
+        "       sbrs  %[byte],7       \n\t"    /*  '1' [04] '0' [03]           */ \
+        w_st("%[lo]")                          /*  '1' [--] '0' [05] - fe-low  */ \
+        "       lsl   %[byte]         \n\t"    /*  '1' [05] '0' [06]           */ \
+        w2_nopseq \
+        "       brcc  " label "skip%= \n\t"    /*  '1' [+1] '0' [+2]           */ \
+        w_st("%[lo]")                          /*  '1' [+3] '0' [--] - fe-high */ \
+        label "skip%=:                \n\t"    /*  '1' [+3] '0' [+2]           */ \
+        w3_nopseq \
+        "       dec   %[ctr]          \n\t"    /*  '1' [+4] '0' [+3]           */ \
+        "       brne  " label "%=     \n\t"    /*  '1' [+5] '0' [+4]           */
 
 #ifdef WS2812_TARGET_PLATFORM_AVR
 /**
  * @brief Halts the program for a given ammount of microseconds.
  * 
- * The following function temporarily disables interrupts and pauses the program
- * code for a provided ammount of microseconds (max 255).
+ * The following function pauses the program code for a provided ammount of
+ * microseconds. Interrupts are left untouched, as they may only
+ * stretch the delay, which is harmless for a reset.
  * 
  * @warning This function relies on the _delay_us() function, which reserves
  *      the CPU from performing any other tasks.
  * @warning Since the for loop of this function also requires time to be executed,
  *      the actual delay will always be slighly longer. 
  */
-void delay_us(uint8_t us)
+void delay_us(uint16_t us)
 {
-        cli();
-        for (uint8_t i = 0; i < us; i++)
+        for (uint16_t i = 0; i < us; i++)
                 _delay_us(1);
-        sei();
 }
 #endif
 
@@ -131,22 +280,68 @@ uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
         uint8_t pin_msk = 0;
 
 #ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+        uint8_t pin_msk2 = 0;
+
+        dev->port = portOutputRegister(digitalPinToPort(cfg->pins[0]));
+        dev->port2 = NULL;
+
+        // Pins on a second port are only driven by ws2812_tx() and ws2812_tx_parallel()
         for (uint8_t i = 0; i < cfg->n_dev; i++) {
-                if (i+1 < cfg->n_dev &&
-                    digitalPinToPort(cfg->pins[i]) != digitalPinToPort(cfg->pins[i+1]))
-                        return 2; // Pins do not share same port!
+                volatile uint8_t *port = portOutputRegister(digitalPinToPort(cfg->pins[i]));
+
+                if (port == dev->port) {
+                        pin_msk |= digitalPinToBitMask(cfg->pins[i]);
+                } else if (dev->port2 == NULL || port == dev->port2) {
+                        dev->port2 = port;
+                        pin_msk2 |= digitalPinToBitMask(cfg->pins[i]);
+                } else {
+                        return 2; // Pins span more than two ports!
+                }
+
                 pinMode(cfg->pins[i], OUTPUT);
-                pin_msk |= digitalPinToBitMask(cfg->pins[i]);
         }
-        dev->port = portOutputRegister(digitalPinToPort(cfg->pins[0]));
+
+        if (dev->port2 != NULL) {
+                dev->masklo2 = ~pin_msk2 & *(dev->port2);
+                dev->maskhi2 = pin_msk2 | *(dev->port2);
+        }
+
+#ifdef WS2812_AVR_IO_PORT
+        // All pins must lie on the port written through OUT
+        if (dev->port != &WS2812_AVR_IO_PORT || dev->port2 != NULL)
+                return 3; // Port does not match the port written through OUT!
+#endif
 #else
         for (uint8_t i = 0; i < cfg->n_dev; i++)
                 pin_msk |= 1 << cfg->pins[i];
 
         *cfg->ddr = pin_msk;
         dev->port = cfg->port;
+
+#ifdef WS2812_AVR_IO_PORT
+        if (dev->port != &WS2812_AVR_IO_PORT)
+                return 3; // Port does not match the port written through OUT!
+#endif
 #endif
         dev->rst_time_us = cfg->rst_time_us;
+        dev->prep = false;
+        dev->brightness = 255;
+        dev->lut = NULL;
+        dev->now_us = NULL;
+#ifdef WS2812_STATS
+        dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+        dev->power = NULL;
+        dev->n_pins = 0;
+
+        // Pins on a second port are only accounted by ws2812_tx_parallel()
+        for (uint8_t msk = pin_msk; msk != 0; msk >>= 1)
+                dev->n_pins += msk & 1;
+#endif
+        dev->rst_pending = false;
+        dev->irq = ws2812_irq_call;
+        dev->irq_pxls = 1;
         dev->masklo = ~pin_msk & *(dev->port);
         dev->maskhi = pin_msk | *(dev->port);
         
@@ -158,9 +353,12 @@ uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
 // Refer to header for documentation
 void ws2812_prep_tx(ws2812 *dev)
 {
-        if (_prep == false) {
-                _sreg_prev = SREG;
-                _prep = true;
+        if (dev->prep == false) {
+                _ws2812_finish_rst(dev);
+                dev->sreg_prev = SREG;
+                if (dev->irq == ws2812_irq_frame)
+                        cli();
+                dev->prep = true;
         }
 }
 
@@ -174,110 +372,933 @@ void ws2812_wait_rst(ws2812 *dev)
 #endif
 }
 
-// Disable optimizations as they may interfere with timing 
-#pragma GCC push_options
-#pragma GCC optimize ("O0")
+/**
+ * @brief Returns the number of LEDs to be transmitted before the next interrupt window is due.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param left Number of LEDs left until the next interrupt window
+ * @param n_pxls Number of LEDs left to be transmitted
+ */
+static inline size_t _ws2812_irq_span(ws2812 *dev, uint8_t left, size_t n_pxls)
+{
+        if (dev->irq == ws2812_irq_pxls && n_pxls > left)
+                return left;
+
+        return n_pxls;
+}
 
 /**
- * @brief Transmits a byte of data to the \ref ws2812 "WS2812 device".
+ * @brief Accounts for transmitted LEDs and serves pending interrupts once an interrupt window is due.
  * 
- * The following function transmits a single byte of data to the provided \ref ws2812 "WS2812 device".
- * It is primarily based on the driver code of [cpldcpu's light_ws2812](https://github.com/cpldcpu/light_ws2812)
- * library and achieves precisely timed communication with the WS2812 device
- * through inline AVR assembly code.
+ * The window is only opened if interrupts were enabled by the caller of the
+ * transmission (sreg). Every NOP between SEI and CLI allows one pending interrupt
+ * to be served, as the CPU executes one instruction after returning from an interrupt.
+ * The window is recorded as a gap in the stats of the device, if any.
  * 
- * @note This function disables interrupts for the duration of the transmission.
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param sreg SREG of the caller of the transmission
+ * @param left Number of LEDs left until the next interrupt window
+ * @param n_pxls Number of LEDs transmitted since the last call (must not exceed left)
+ */
+static inline void _ws2812_irq_window(ws2812 *dev, uint8_t sreg, uint8_t *left, size_t n_pxls)
+{
+        if (dev->irq != ws2812_irq_pxls)
+                return;
+
+        *left -= n_pxls;
+
+        if (*left == 0) {
+                *left = dev->irq_pxls;
+                if (sreg & _BV(SREG_I)) {
+                        _ws2812_stats_pause(dev);
+                        asm volatile("sei\n\tnop\n\tcli" ::: "memory");
+                        _ws2812_stats_resume(dev);
+                }
+        }
+}
+
+/*
+ * Fetches the next color byte of the current pixel into %[byte].
+ *
+ * The pixel base address is copied into Z and offset by the rgbmap entry
+ * of the byte, so that the color order is resolved without touching memory.
+ * The fetch is executed in the low phase of the previous bit, stretching it
+ * by 5 cycles (11 cycles between two pixels).
+ */
+#define w_fetchbyte(offset) \
+        "       movw  %[z],%[pxl]           \n\t" \
+        "       add   %A[z]," offset "      \n\t" \
+        "       adc   %B[z],__zero_reg__    \n\t" \
+        "       ld    %[byte],Z             \n\t"
+
+/*
+ * Flash equivalent of w_fetchbyte(), taking 6 instead of 5 cycles.
+ */
+#define w_fetchbyte_P(offset) \
+        "       movw  %[z],%[pxl]           \n\t" \
+        "       add   %A[z]," offset "      \n\t" \
+        "       adc   %B[z],__zero_reg__    \n\t" \
+        "       lpm   %[byte],Z             \n\t"
+
+/*
+ * Far flash equivalent of w_fetchbyte() for a 24 bit address in %[pxl],
+ * taking 9 instead of 5 cycles.
+ */
+#define w_fetchbyte_PF(offset) \
+        "       movw  %[z],%A[pxl]          \n\t" \
+        "       mov   __tmp_reg__,%C[pxl]   \n\t" \
+        "       add   %A[z]," offset "      \n\t" \
+        "       adc   %B[z],__zero_reg__    \n\t" \
+        "       adc   __tmp_reg__,__zero_reg__ \n\t" \
+        "       out   %[rampz],__tmp_reg__  \n\t" \
+        "       elpm  %[byte],Z             \n\t"
+
+/*
+ * Scales the byte held in %[byte] by the brightness of the device.
+ *
+ * %[scale] holds the brightness + 1, hence 0 for full brightness, in which case
+ * the scaling is skipped (3 cycles). Otherwise the byte is replaced by the high byte of
+ * %[byte] * %[scale], stretching the low phase by 6 cycles with the hardware multiplier
+ * and by 37 cycles with the shift-and-add sequence of chips lacking it.
+ * The label prefix must be unique within the asm statement it is used in.
+ */
+#ifdef __AVR_HAVE_MUL__
+#define w_scalebyte(label) \
+        "       tst   %[scale]              \n\t" \
+        "       breq  " label "%=           \n\t" \
+        "       mul   %[byte],%[scale]      \n\t" \
+        "       mov   %[byte],__zero_reg__  \n\t" \
+        "       clr   __zero_reg__          \n\t" \
+        label "%=:                          \n\t"
+#else
+#define w_scalebyte(label) \
+        "       tst   %[scale]              \n\t" \
+        "       breq  " label "%=           \n\t" \
+        "       mov   __tmp_reg__,%[scale]  \n\t" \
+        "       .rept 8                     \n\t" \
+        "       lsr   __tmp_reg__           \n\t" \
+        "       brcc  .+2                   \n\t" \
+        "       add   __zero_reg__,%[byte]  \n\t" \
+        "       ror   __zero_reg__          \n\t" \
+        "       .endr                       \n\t" \
+        "       mov   %[byte],__zero_reg__  \n\t" \
+        "       clr   __zero_reg__          \n\t" \
+        label "%=:                          \n\t"
+#endif
+
+/*
+ * Translates the byte held in %[byte] through the flash LUT of the device.
+ *
+ * %[lut] holds the flash address of the LUT. The lookup is skipped if it is NULL (4 cycles),
+ * otherwise it stretches the low phase by 9 cycles (10 without lpm Rd,Z). Z is clobbered.
+ * The label prefix must be unique within the asm statement it is used in.
+ */
+#ifdef __AVR_HAVE_LPMX__
+#define w_lpmbyte \
+        "       lpm   %[byte],Z             \n\t"
+#else
+#define w_lpmbyte \
+        "       lpm                         \n\t" \
+        "       mov   %[byte],__tmp_reg__   \n\t"
+#endif
+#define w_lutbyte(label) \
+        "       mov   __tmp_reg__,%A[lut]   \n\t" \
+        "       or    __tmp_reg__,%B[lut]   \n\t" \
+        "       breq  " label "%=           \n\t" \
+        "       movw  %[z],%[lut]           \n\t" \
+        "       add   %A[z],%[byte]         \n\t" \
+        "       adc   %B[z],__zero_reg__    \n\t" \
+        w_lpmbyte \
+        label "%=:                          \n\t"
+
+/*
+ * Adds the LUT corrected byte held in %[byte] to the 32 bit power sum in %[sum].
+ *
+ * The sum is accumulated ahead of the brightness scaling, as the power limiter derives the
+ * brightness from it, stretching the low phase by 4 cycles. It is only assembled, and
+ * the [sum] operand only passed by w_sum, if the build flag `WS2812_POWER` is set.
+ */
+#ifdef WS2812_POWER
+#define w_sumbyte \
+        "       add   %A[sum],%[byte]       \n\t" \
+        "       adc   %B[sum],__zero_reg__  \n\t" \
+        "       adc   %C[sum],__zero_reg__  \n\t" \
+        "       adc   %D[sum],__zero_reg__  \n\t"
+#define w_sum , [sum] "+r" (sum)
+#else
+#define w_sumbyte
+#define w_sum
+#endif
+
+/*
+ * Applies the LUT and brightness of the device to the byte held in %[byte],
+ * accounting the LUT corrected byte in %[sum] on the way.
+ */
+#define w_correctbyte(label) \
+        w_lutbyte("l" label) \
+        w_sumbyte \
+        w_scalebyte("s" label)
+
+/*
+ * Transmits the three color bytes of a pixel, fetched through the provided fetch macro
+ * and corrected by the LUT and brightness of the device.
+ */
+#define w_txpxl(fetch) \
+        fetch("%[o0]") \
+        w_correctbyte("0_") \
+        w_txbyte("b0_") \
+        fetch("%[o1]") \
+        w_correctbyte("1_") \
+        w_txbyte("b1_") \
+        fetch("%[o2]") \
+        w_correctbyte("2_") \
+        w_txbyte("b2_")
+
+/**
+ * @brief Transmits an array of RGB values to the \ref ws2812 "WS2812 device" in a single pass.
  * 
+ * The following function transmits an entire frame of RGB values to the provided
+ * \ref ws2812 "WS2812 device" within one inline assembly loop. The pixel pointer, the
+ * pixel counter and the color order offsets are held in registers for the entire
+ * transmission, thus the only time spent between two bytes is the fetch and correction
+ * of the next color byte. After every pixel, the pixel pointer is advanced by step
+ * RGB values, thus a negative step transmits the frame backwards from leds.
+ * 
+ * @return Sum of the LUT corrected color bytes (0 unless the build flag `WS2812_POWER` is set)
+ * 
+ * @warning Interrupts must be disabled by the caller, as any interrupt
+ *      occuring mid transmission will stretch the data signal.
+ * @warning n_leds must not be 0.
  */
-void ws2812_tx_byte(ws2812 *dev, uint8_t byte)
+static uint32_t ws2812_tx_frame(ws2812 *dev, const ws2812_rgb *leds, size_t n_leds, int8_t step)
+{
+        uint8_t ctr;
+        uint8_t byte;
+        uint8_t *z;
+        uint32_t sum = 0;
+
+        asm volatile(
+                "pxl%=:                     \n\t"
+                w_txpxl(w_fetchbyte)
+                "       add   %A[pxl],%A[step] \n\t"    // Advance to next pixel
+                "       adc   %B[pxl],%B[step] \n\t"
+                "       subi  %A[n],1          \n\t"    // Decrement remaining pixels
+                "       sbci  %B[n],0          \n\t"
+                "       brne  pxl%=            \n\t"
+                :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "=&z" (z),
+                        [pxl] "+d" (leds), [n] "+d" (n_leds) w_sum
+                :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                        [o0] "r" (dev->rgbmap[0]), [o1] "r" (dev->rgbmap[1]), [o2] "r" (dev->rgbmap[2]),
+                        [scale] "r" ((uint8_t) (dev->brightness + 1)), [lut] "r" (dev->lut),
+                        [step] "r" ((int16_t) step * (int16_t) sizeof(ws2812_rgb))
+                :	"memory"
+        );
+
+        return sum;
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+        if (n_leds == 0)
+                return;
+
+#ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+        // Devices spanning two ports output the same RGB values on all lanes
+        if (dev->port2 != NULL) {
+                ws2812_rgb *lanes[16];
+
+                for (uint8_t l = 0; l < 16; l++)
+                        lanes[l] = leds;
+
+                ws2812_tx_parallel(dev, lanes, n_leds);
+                return;
+        }
+#endif
+
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0, n; i < n_leds; i += n) {
+                n = _ws2812_irq_span(dev, left, n_leds - i);
+                sum += ws2812_tx_frame(dev, leds + i, n, 1);
+                _ws2812_irq_window(dev, sreg, &left, n);
+        }
+
+        _ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+
+#ifdef __AVR_HAVE_LPMX__
+// Refer to header for documentation
+void ws2812_tx_P(ws2812 *dev, const ws2812_rgb *leds_P, size_t n_leds)
+{
+        if (n_leds == 0)
+                return;
+
+        uint8_t ctr;
+        uint8_t byte;
+        uint8_t *z;
+        const ws2812_rgb *pxl = leds_P;
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0, span; i < n_leds; i += span) {
+                size_t n = span = _ws2812_irq_span(dev, left, n_leds - i);
+
+                asm volatile(
+                        "pxl%=:                     \n\t"
+                        w_txpxl(w_fetchbyte_P)
+                        "       subi  %A[pxl],lo8(-3)  \n\t"    // Advance to next pixel
+                        "       sbci  %B[pxl],hi8(-3)  \n\t"
+                        "       subi  %A[n],1          \n\t"    // Decrement remaining pixels
+                        "       sbci  %B[n],0          \n\t"
+                        "       brne  pxl%=            \n\t"
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "=&z" (z),
+                                [pxl] "+d" (pxl), [n] "+d" (n) w_sum
+                        :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                                [o0] "r" (dev->rgbmap[0]), [o1] "r" (dev->rgbmap[1]), [o2] "r" (dev->rgbmap[2]),
+                                [scale] "r" ((uint8_t) (dev->brightness + 1)), [lut] "r" (dev->lut)
+                );
+
+                _ws2812_irq_window(dev, sreg, &left, span);
+        }
+
+        _ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+#endif
+
+#ifdef __AVR_HAVE_ELPM__
+// Refer to header for documentation
+void ws2812_tx_PF(ws2812 *dev, uint32_t leds_PF, size_t n_leds)
+{
+        if (n_leds == 0)
+                return;
+
+        uint8_t ctr;
+        uint8_t byte;
+        uint8_t *z;
+        uint8_t rampz = RAMPZ;
+        uint32_t pxl = leds_PF;
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0, span; i < n_leds; i += span) {
+                size_t n = span = _ws2812_irq_span(dev, left, n_leds - i);
+
+                asm volatile(
+                        "pxl%=:                     \n\t"
+                        w_txpxl(w_fetchbyte_PF)
+                        "       subi  %A[pxl],lo8(-3)  \n\t"    // Advance to next pixel
+                        "       sbci  %B[pxl],hi8(-3)  \n\t"
+                        "       sbci  %C[pxl],hh8(-3)  \n\t"
+                        "       sbiw  %[n],1           \n\t"    // Decrement remaining pixels
+                        "       brne  pxl%=            \n\t"
+                        :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "=&z" (z),
+                                [pxl] "+d" (pxl), [n] "+w" (n) w_sum
+                        :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                                [o0] "r" (dev->rgbmap[0]), [o1] "r" (dev->rgbmap[1]), [o2] "r" (dev->rgbmap[2]),
+                                [scale] "r" ((uint8_t) (dev->brightness + 1)), [lut] "r" (dev->lut),
+                                [rampz] "I" (_SFR_IO_ADDR(RAMPZ))
+                );
+
+                _ws2812_irq_window(dev, sreg, &left, span);
+        }
+
+        _ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+        RAMPZ = rampz;
+
+        _ws2812_power_add(dev, sum);
+}
+#endif
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
 {
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                ws2812_rgb pxl = gen(i, ctx);
+                sum += ws2812_tx_frame(dev, &pxl, 1, 1);
+                _ws2812_irq_window(dev, sreg, &left, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+
+// Refer to header for documentation
+void ws2812_tx_layout(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls)
+{
+        uint16_t w = layout->width;
+
+        if (w == 0)
+                return;
+
+#ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+        // Devices spanning two ports can only be driven by ws2812_tx()
+        if (dev->port2 != NULL) {
+                _ws2812_tx_layout_rows(dev, layout, pxls);
+                return;
+        }
+#endif
+
+        const ws2812_rgb *row;
+        bool rev;
+        size_t n_pxls = 0;
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
         cli();
+        _ws2812_stats_begin(dev);
+
+        // Rows wired from their last LED are transmitted backwards from their last RGB value
+        for (uint16_t i = 0; (row = _ws2812_layout_row(layout, pxls, i, &rev)) != NULL; i++) {
+                int8_t step = rev ? -1 : 1;
+                const ws2812_rgb *pxl = rev ? row + w - 1 : row;
+
+                for (size_t j = 0, n; j < w; j += n) {
+                        n = _ws2812_irq_span(dev, left, w - j);
+                        sum += ws2812_tx_frame(dev, pxl, n, step);
+                        pxl += rev ? -(ptrdiff_t) n : (ptrdiff_t) n;
+                        _ws2812_irq_window(dev, sreg, &left, n);
+                }
+
+                n_pxls += w;
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+
+/**
+ * @brief Transmits a stream of bytes to the \ref ws2812 "WS2812 device" in a single pass.
+ * 
+ * The following function transmits the provided bytes as they are, without
+ * mapping them to the color order of the device.
+ * 
+ * @return Sum of the LUT corrected bytes (0 unless the build flag `WS2812_POWER` is set)
+ * 
+ * @warning Interrupts must be disabled by the caller, as any interrupt
+ *      occuring mid transmission will stretch the data signal.
+ * @warning n_bytes must not be 0.
+ */
+static inline uint32_t ws2812_tx_stream(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
         uint8_t ctr;
+        uint8_t byte;
+        uint8_t *z;
+        uint32_t sum = 0;
 
         asm volatile(
-                "       ldi   %0,8  \n\t"
-                "loop%=:            \n\t"
-                "       st    X,%3 \n\t"    //  '1' [02] '0' [02] - re
-                #if (w1_nops&1)
-                w_nop1
-                #endif
-                #if (w1_nops&2)
-                w_nop2
-                #endif
-                #if (w1_nops&4)
-                w_nop4
-                #endif
-                #if (w1_nops&8)
-                w_nop8
-                #endif
-                #if (w1_nops&16)
-                w_nop16
-                #endif
-                "       sbrs  %1,7  \n\t"    //  '1' [04] '0' [03]
-                "       st    X,%4 \n\t"     //  '1' [--] '0' [05] - fe-low
-                "       lsl   %1    \n\t"    //  '1' [05] '0' [06]
-                #if (w2_nops&1)
-                w_nop1
-                #endif
-                #if (w2_nops&2)
-                w_nop2
-                #endif
-                #if (w2_nops&4)
-                w_nop4
-                #endif
-                #if (w2_nops&8)
-                w_nop8
-                #endif
-                #if (w2_nops&16)
-                w_nop16 
-                #endif
-                "       brcc skipone%= \n\t"    //  '1' [+1] '0' [+2] - 
-                "       st   X,%4      \n\t"    //  '1' [+3] '0' [--] - fe-high
-                "skipone%=:               "     //  '1' [+3] '0' [+2] - 
-
-                #if (w3_nops&1)
-                w_nop1
-                #endif
-                #if (w3_nops&2)
-                w_nop2
-                #endif
-                #if (w3_nops&4)
-                w_nop4
-                #endif
-                #if (w3_nops&8)
-                w_nop8
-                #endif
-                #if (w3_nops&16)
-                w_nop16
-                #endif
-                "       dec   %0    \n\t"    //  '1' [+4] '0' [+3]
-                "       brne  loop%=\n\t"    //  '1' [+5] '0' [+4]
-                :	"=&d" (ctr)
-                :	"r" (byte), "x" ((uint8_t *) dev->port), "r" (dev->maskhi), "r" (dev->masklo)
+                "byte%=:                    \n\t"
+                "       movw  %[z],%[p]        \n\t"    // Fetch next byte
+                "       ld    %[byte],Z+       \n\t"
+                "       movw  %[p],%[z]        \n\t"
+                w_correctbyte("_")
+                w_txbyte("b_")
+                "       sbiw  %[n],1           \n\t"    // Decrement remaining bytes
+                "       brne  byte%=           \n\t"
+                :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [z] "=&z" (z),
+                        [p] "+r" (bytes), [n] "+w" (n_bytes) w_sum
+                :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                        [scale] "r" ((uint8_t) (dev->brightness + 1)), [lut] "r" (dev->lut)
+                :	"memory"
         );
-        sei();
+
+        return sum;
 }
 
-#pragma GCC pop_options
+/**
+ * @brief Transmits the same RGB value repeatedly to the \ref ws2812 "WS2812 device".
+ * 
+ * The following function transmits the color order mapped bytes c0, c1 and c2 n_pxls times.
+ * The bytes are expected to be scaled by the brightness of the device already.
+ * The bytes are held in registers for the entire transmission, thus no memory is accessed
+ * throughout the transmission.
+ * 
+ * @warning Interrupts must be disabled by the caller, as any interrupt
+ *      occuring mid transmission will stretch the data signal.
+ * @warning n_pxls must not be 0.
+ */
+static inline void ws2812_tx_repeat(ws2812 *dev, uint8_t c0, uint8_t c1, uint8_t c2, size_t n_pxls)
+{
+        uint8_t ctr;
+        uint8_t byte;
+
+        asm volatile(
+                "pxl%=:                     \n\t"
+                "       mov   %[byte],%[c0]    \n\t"
+                w_txbyte("b0_")
+                "       mov   %[byte],%[c1]    \n\t"
+                w_txbyte("b1_")
+                "       mov   %[byte],%[c2]    \n\t"
+                w_txbyte("b2_")
+                "       sbiw  %[n],1           \n\t"    // Decrement remaining pixels
+                "       brne  pxl%=            \n\t"
+                :	[ctr] "=&d" (ctr), [byte] "=&r" (byte), [n] "+w" (n_pxls)
+                :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                        [c0] "r" (c0), [c1] "r" (c1), [c2] "r" (c2)
+        );
+}
 
 // Refer to header for documentation
-void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
 {
-        for (size_t i = 0; i < n_leds; i++) {
-                for (uint8_t j = 0; j < sizeof(dev->rgbmap); j++) {
-                        uint8_t *pxl = (uint8_t *) &(leds[i]);
-                        ws2812_tx_byte(dev, pxl[dev->rgbmap[j]]);
+        if (n_pxls == 0)
+                return;
+
+        uint8_t *pxl = (uint8_t *) &color;
+        uint8_t c0 = _ws2812_correct(dev, pxl[dev->rgbmap[0]]);
+        uint8_t c1 = _ws2812_correct(dev, pxl[dev->rgbmap[1]]);
+        uint8_t c2 = _ws2812_correct(dev, pxl[dev->rgbmap[2]]);
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0, n; i < n_pxls; i += n) {
+                n = _ws2812_irq_span(dev, left, n_pxls - i);
+                ws2812_tx_repeat(dev, c0, c1, c2, n);
+                _ws2812_irq_window(dev, sreg, &left, n);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_fill(dev, color, n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+        size_t n_pxls = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_runs; i++) {
+                const uint8_t *pxl = (const uint8_t *) &(runs[i].color);
+                uint8_t c0 = _ws2812_correct(dev, pxl[dev->rgbmap[0]]);
+                uint8_t c1 = _ws2812_correct(dev, pxl[dev->rgbmap[1]]);
+                uint8_t c2 = _ws2812_correct(dev, pxl[dev->rgbmap[2]]);
+
+                for (size_t j = 0, n; j < runs[i].n_pxls; j += n) {
+                        n = _ws2812_irq_span(dev, left, runs[i].n_pxls - j);
+                        ws2812_tx_repeat(dev, c0, c1, c2, n);
+                        _ws2812_irq_window(dev, sreg, &left, n);
                 }
+
+                _ws2812_power_fill(dev, runs[i].color, runs[i].n_pxls);
+                n_pxls += runs[i].n_pxls;
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+        if (n_bytes == 0)
+                return;
+
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        // Interrupt windows are counted in units of 3 bytes, just as for ws2812_tx()
+        for (size_t i = 0, n; i < n_bytes; i += n) {
+                n = _ws2812_irq_span(dev, left, (n_bytes - i + 2) / 3) * 3;
+                if (n > n_bytes - i)
+                        n = n_bytes - i;
+
+                sum += ws2812_tx_stream(dev, bytes + i, n);
+                _ws2812_irq_window(dev, sreg, &left, (n + 2) / 3);
+        }
+
+        _ws2812_stats_end(dev, n_bytes, 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                       const ws2812_rgb *palette, size_t n_pxls)
+{
+        if (bits_per_index != 1 && bits_per_index != 2 &&
+            bits_per_index != 4 && bits_per_index != 8)
+                return;
+
+        uint8_t shift = 8 - bits_per_index;
+        uint8_t per_byte = 8 / bits_per_index;
+        uint8_t remaining = 0;
+        uint8_t cur = 0;
+
+        uint32_t sum = 0;
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                if (remaining == 0) {
+                        cur = *indices++;
+                        remaining = per_byte;
+                }
+
+                uint8_t idx = cur >> shift;
+                cur <<= bits_per_index;
+                remaining--;
+
+                sum += ws2812_tx_stream(dev, (const uint8_t *) &palette[idx], sizeof(ws2812_rgb));
+                _ws2812_irq_window(dev, sreg, &left, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+
+        _ws2812_power_add(dev, sum);
+}
+
+// Longest low phase in ns the WS2812 are known to tolerate within a frame, before the
+// time spent between two bytes risks being taken for a reset
+#define w_lowmax 5000
+
+// Resulting low phase between two bytes of ws2812_tx_slices() in ns
+#define w_lowgap (((w3_nops+39)*1000000)/(F_CPU/1000))
+#if w_lowgap>w_lowmax
+   #error "Light_ws2812: Sorry, the clock speed is too low to drive lanes in parallel."
+#endif
+
+/*
+ * Transmits one bit sliced byte of 8 lanes, loaded from Z, see ws2812_tx_slices().
+ *
+ * Z is advanced to the next byte of all lanes. The label prefix must be unique
+ * within the asm statement it is used in.
+ */
+#define w_txslices(label) \
+        "       ld    %[v0],Z+        \n\t"    /* Load next byte of all lanes */ \
+        "       ld    %[v1],Z+        \n\t" \
+        "       ld    %[v2],Z+        \n\t" \
+        "       ld    %[v3],Z+        \n\t" \
+        "       ld    %[v4],Z+        \n\t" \
+        "       ld    %[v5],Z+        \n\t" \
+        "       ld    %[v6],Z+        \n\t" \
+        "       ld    %[v7],Z+        \n\t" \
+        "       ldi   %[ctr],8        \n\t" \
+        label "%=:                    \n\t" \
+        "       lsl   %[v7]           \n\t"    /* Bit slice MSBs of all lanes */ \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v6]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v5]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v4]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v3]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v2]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v1]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       lsl   %[v0]           \n\t" \
+        "       rol   %[s]            \n\t" \
+        "       and   %[s],%[msk]     \n\t"    /* Keep data pins only */ \
+        "       or    %[s],%[lo]      \n\t"    /* Apply remaining port state */ \
+        w_st("%[hi]")                          /*  [02] - re                   */ \
+        w1_nopseq \
+        "       nop                   \n\t"    /*  [03]                        */ \
+        w_st("%[s]")                           /*  [05] - fe-low  ('0' lanes)  */ \
+        w2_nopseq \
+        "       nop                   \n\t"    /*  [06]                        */ \
+        w_nopio                                /*  Pad the '1' pulse if written through OUT */ \
+        w_st("%[lo]")                          /*  [+2] - fe-high ('1' lanes)  */ \
+        w3_nopseq \
+        "       dec   %[ctr]          \n\t"    /*  [+3]                        */ \
+        "       brne  " label "%=     \n\t"    /*  [+5]                        */
+
+/**
+ * @brief Transmits one bit sliced pixel of up to 8 lanes to the \ref ws2812 "WS2812 device".
+ * 
+ * The following function transmits the three color bytes of every lane in parallel, where the
+ * bytes of lane n are output on bit n of the port register. Before every bit slot, the MSBs
+ * of all lane bytes are bit sliced into a single port value, which is written to the port
+ * once the "0" pulse has elapsed. Thus, pins of lanes transmitting a "0" are pulled low,
+ * while pins of lanes transmitting a "1" stay high until the "1" pulse has elapsed.
+ * 
+ * The bytes are expected to be corrected already and ordered as by _ws2812_correct_lanes(),
+ * thus the only time spent between two bytes is loading the next byte of all lanes, which
+ * stretches the low phase by another 20 cycles (see w_lowgap). The bit slicing is executed
+ * in the low phase of every bit, stretching it by 19 cycles.
+ * 
+ * @warning Interrupts must be disabled by the caller, as any interrupt
+ *      occuring mid transmission will stretch the data signal.
+ */
+static inline void ws2812_tx_slices(ws2812 *dev, const uint8_t *v, uint8_t pin_msk)
+{
+        uint8_t ctr;
+        uint8_t slice;
+        uint8_t v0, v1, v2, v3, v4, v5, v6, v7;
+
+        asm volatile(
+                w_txslices("b0_")
+                w_txslices("b1_")
+                w_txslices("b2_")
+                :	[ctr] "=&d" (ctr), [s] "=&r" (slice), [z] "+z" (v),
+                        [v0] "=&r" (v0), [v1] "=&r" (v1), [v2] "=&r" (v2), [v3] "=&r" (v3),
+                        [v4] "=&r" (v4), [v5] "=&r" (v5), [v6] "=&r" (v6), [v7] "=&r" (v7)
+                :	w_port, [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                        [msk] "r" (pin_msk)
+                :	"memory"
+        );
+}
+
+#ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+// Resulting pulse length of the "0" for devices spanning two ports, see ws2812_tx_slices2()
+#define w_lowtime2 ((w1_nops+4)*1000000)/(F_CPU/1000)
+#ifdef WS2812_T0H_MAX_NS
+  #if w_lowtime2>WS2812_T0H_MAX_NS
+   #error "Light_ws2812: Sorry, the clock speed is too low to drive pins on two ports with the selected timing profile."
+  #endif
+#elif w_lowtime2>550
+   #error "Light_ws2812: Sorry, the clock speed is too low to drive pins on two ports."
+#endif
+
+// Resulting low phase between two bytes of ws2812_tx_slices2() in ns. As the bit slicing of 16
+// lanes already stretches every low phase beyond w_lowmax at 8 MHz, this is only warned about.
+#define w_lowgap2 (((w3_nops+73)*1000000)/(F_CPU/1000))
+#if w_lowgap2>w_lowmax
+   #warning "Light_ws2812: The low phase between two bytes exceeds 5us on devices spanning two ports."
+   #warning "Please consider a higher clockspeed, if possible"
+#endif
+
+// Corrected bytes of the pixel transmitted by ws2812_tx_slices2(), see _ws2812_correct_lanes()
+// The buffer is addressed directly, as no pointer register is left to the transmit loop.
+static uint8_t _ws2812_slices2[3 * 16];
+
+/*
+ * Transmits one bit sliced byte of 16 lanes, loaded from _ws2812_slices2 at the given
+ * offset, see ws2812_tx_slices2(). The label prefix must be unique within the asm
+ * statement it is used in.
+ */
+#define w_txslices2(label, offset) \
+        "       lds   %[v0],%[buf]+"  offset "+0  \n\t"    /* Load next byte of all lanes */ \
+        "       lds   %[v1],%[buf]+"  offset "+1  \n\t" \
+        "       lds   %[v2],%[buf]+"  offset "+2  \n\t" \
+        "       lds   %[v3],%[buf]+"  offset "+3  \n\t" \
+        "       lds   %[v4],%[buf]+"  offset "+4  \n\t" \
+        "       lds   %[v5],%[buf]+"  offset "+5  \n\t" \
+        "       lds   %[v6],%[buf]+"  offset "+6  \n\t" \
+        "       lds   %[v7],%[buf]+"  offset "+7  \n\t" \
+        "       lds   %[v8],%[buf]+"  offset "+8  \n\t" \
+        "       lds   %[v9],%[buf]+"  offset "+9  \n\t" \
+        "       lds   %[v10],%[buf]+" offset "+10 \n\t" \
+        "       lds   %[v11],%[buf]+" offset "+11 \n\t" \
+        "       lds   %[v12],%[buf]+" offset "+12 \n\t" \
+        "       lds   %[v13],%[buf]+" offset "+13 \n\t" \
+        "       lds   %[v14],%[buf]+" offset "+14 \n\t" \
+        "       lds   %[v15],%[buf]+" offset "+15 \n\t" \
+        "       ldi   %[ctr],8        \n\t" \
+        label "%=:                    \n\t" \
+        "       lsl   %[v7]           \n\t"    /* Bit slice MSBs of the lanes of the first port */ \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v6]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v5]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v4]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v3]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v2]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v1]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v0]           \n\t" \
+        "       rol   __tmp_reg__     \n\t" \
+        "       lsl   %[v15]          \n\t"    /* Bit slice MSBs of the lanes of the second port */ \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v14]          \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v13]          \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v12]          \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v11]          \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v10]          \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v9]           \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       lsl   %[v8]           \n\t" \
+        "       rol   %[s2]           \n\t" \
+        "       or    __tmp_reg__,%[lo] \n\t"  /* Apply remaining port states */ \
+        "       or    %[s2],%[lo2]    \n\t" \
+        "       st    X,%[hi]         \n\t"    /*  [02] - re (first port)                      */ \
+        "       st    Z,%[hi2]        \n\t"    /*  [04] - re (second port)                     */ \
+        w1_nopseq \
+        "       st    X,__tmp_reg__   \n\t"    /*  [06] - fe-low  ('0' lanes, first port)      */ \
+        "       st    Z,%[s2]         \n\t"    /*  [08] - fe-low  ('0' lanes, second port)     */ \
+        w2_nopseq \
+        "       st    X,%[lo]         \n\t"    /*  [+2] - fe-high ('1' lanes, first port)      */ \
+        "       st    Z,%[lo2]        \n\t"    /*  [+4] - fe-high ('1' lanes, second port)     */ \
+        w3_nopseq \
+        "       dec   %[ctr]          \n\t"    /*  [+5]                                        */ \
+        "       brne  " label "%=     \n\t"    /*  [+7]                                        */
+
+/**
+ * @brief Transmits one bit sliced pixel of up to 16 lanes to a \ref ws2812 "WS2812 device" spanning two ports.
+ * 
+ * The following function is the two port equivalent of ws2812_tx_slices(), transmitting the pixel
+ * held in _ws2812_slices2, where the bytes of lane n are output on bit n of the first port for lanes
+ * 0-7, and on bit n - 8 of the second port for lanes 8-15. Every edge is written to the first port and
+ * then to the second port, hence the signal of the second port trails the signal of the first port by 2
+ * cycles. Both pulses of a bit are 1 cycle ("0") and 2 cycles ("1") longer than in ws2812_tx_slices().
+ * 
+ * The bit slicing is executed in the low phase of every bit, stretching it by 34 cycles, and
+ * loading the next byte of all lanes stretches the low phase between two bytes by another 34 cycles
+ * (see w_lowgap2). Since all 16 lane bytes are held in registers, a third port would exceed the
+ * register file of the AVR.
+ * 
+ * @warning Interrupts must be disabled by the caller, as any interrupt
+ *      occuring mid transmission will stretch the data signal.
+ * @warning The bytes of lanes without a pin must be 0.
+ */
+static inline void ws2812_tx_slices2(ws2812 *dev)
+{
+        uint8_t ctr;
+        uint8_t slice2;
+        uint8_t v0, v1, v2, v3, v4, v5, v6, v7;
+        uint8_t v8, v9, v10, v11, v12, v13, v14, v15;
+
+        asm volatile(
+                w_txslices2("b0_", "0")
+                w_txslices2("b1_", "16")
+                w_txslices2("b2_", "32")
+                :	[ctr] "=&d" (ctr), [s2] "=&r" (slice2),
+                        [v0] "=&r" (v0), [v1] "=&r" (v1), [v2] "=&r" (v2), [v3] "=&r" (v3),
+                        [v4] "=&r" (v4), [v5] "=&r" (v5), [v6] "=&r" (v6), [v7] "=&r" (v7),
+                        [v8] "=&r" (v8), [v9] "=&r" (v9), [v10] "=&r" (v10), [v11] "=&r" (v11),
+                        [v12] "=&r" (v12), [v13] "=&r" (v13), [v14] "=&r" (v14), [v15] "=&r" (v15)
+                :	"x" (dev->port), "z" (dev->port2),
+                        [hi] "r" (dev->maskhi), [lo] "r" (dev->masklo),
+                        [hi2] "r" (dev->maskhi2), [lo2] "r" (dev->masklo2),
+                        [buf] "i" (_ws2812_slices2)
+                :	"memory"
+        );
+}
+
+/**
+ * @brief Transmits independent RGB values to the lanes of a \ref ws2812 "WS2812 device" spanning two ports.
+ * 
+ * The following function is the two port equivalent of ws2812_tx_parallel(), see ws2812_tx_slices2().
+ */
+static void ws2812_tx_parallel2(ws2812 *dev, ws2812_rgb *lanes[], size_t n_pxls)
+{
+        uint8_t pin_msk = dev->maskhi & ~dev->masklo;
+        uint8_t pin_msk2 = dev->maskhi2 & ~dev->masklo2;
+        ws2812_rgb *lp[16];
+
+        // Lanes of unused pins are transmitted as 0
+        for (uint8_t l = 0; l < 8; l++) {
+                lp[l] = (pin_msk & (1 << l)) ? lanes[l] : NULL;
+                lp[l + 8] = (pin_msk2 & (1 << l)) ? lanes[l + 8] : NULL;
+        }
+
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        // Every pixel is corrected ahead, leaving no work between its bytes
+        for (size_t i = 0; i < n_pxls; i++) {
+                _ws2812_correct_lanes(dev, lp, 16, _ws2812_slices2);
+                ws2812_tx_slices2(dev);
+                _ws2812_irq_window(dev, sreg, &left, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+}
+#endif
+
+// Refer to header for documentation
+void ws2812_tx_parallel(ws2812 *dev, ws2812_rgb *lanes[], size_t n_pxls)
+{
+#ifdef WS2812_TARGET_PLATFORM_ARDUINO_AVR
+        if (dev->port2 != NULL) {
+                ws2812_tx_parallel2(dev, lanes, n_pxls);
+                return;
+        }
+#endif
+
+        uint8_t pin_msk = dev->maskhi & ~dev->masklo;
+        ws2812_rgb *lp[8];
+        uint8_t v[3 * 8];
+
+        // Lanes of unused pins are transmitted as 0
+        for (uint8_t l = 0; l < 8; l++)
+                lp[l] = (pin_msk & (1 << l)) ? lanes[l] : NULL;
+
+        uint8_t left = dev->irq_pxls;
+        uint8_t sreg = SREG;
+        cli();
+        _ws2812_stats_begin(dev);
+
+        // Every pixel is corrected ahead, leaving no work between its bytes
+        for (size_t i = 0; i < n_pxls; i++) {
+                _ws2812_correct_lanes(dev, lp, 8, v);
+                ws2812_tx_slices(dev, v, pin_msk);
+                _ws2812_irq_window(dev, sreg, &left, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+        SREG = sreg;
+}
+
+// Refer to header for documentation
+void _ws2812_release_tx(ws2812 *dev)
+{
+        if (dev->prep == true) {
+                SREG = dev->sreg_prev;
+                dev->prep = false;
         }
 }
 
 // Refer to header for documentation
 void ws2812_close_tx(ws2812 *dev)
 {
-        if (_prep == true) {
-                SREG = _sreg_prev;
-                _prep = false;
-                ws2812_wait_rst(dev);
+        if (dev->prep == true) {
+                _ws2812_release_tx(dev);
+                _ws2812_begin_rst(dev);
         }
 }
 
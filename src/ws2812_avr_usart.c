@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_avr_usart.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Driver code for AVR chips using a USART in Master SPI mode.
+ *
+ * The following file holds the Tiny-WS2812 library code to drive
+ * WS2812 devices on AVR chips through a USART in Master SPI mode (MSPIM).
+ *
+ * Rather than bit-banging the data line with interrupts disabled, every WS2812 bit
+ * is encoded into four SPI bits (`1000` for a '0' and `1100` for a '1'), which are shifted
+ * out on the TxD pin by the USART. The SPI clock is derived from a quarter of the bit period
+ * of the selected timing profile, and a '1' is encoded as `1110` instead if the resulting SPI bits
+ * are too short for its pulse. Every USART byte thus holds two complete WS2812 bits and ends low. Since the USART is double buffered, the next byte can be written
+ * while the current one is still being shifted out, thus interrupts may remain enabled
+ * throughout the entire transmission. An interrupt that stalls the transmission merely stretches
+ * a low phase, which is harmless as long as it does not come close to the reset time of the
+ * WS2812 device(s).
+ */
+
+#ifdef WS2812_TARGET_PLATFORM_AVR_USART
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <avr/io.h>
+#include <util/delay.h>
+
+#include <ws2812.h>
+
+// Timing in ns, unless a timing profile has been selected (see ws2812_common.h)
+#ifdef WS2812_T0H_NS
+  #define w_lowmax      WS2812_T0H_MAX_NS
+  #define w_highmin     WS2812_T1H_MIN_NS
+  #define w_highmax     (WS2812_T1H_NS + 150)
+  #define w_totalperiod WS2812_PERIOD_NS
+#else
+  #define w_lowmax      550
+  #define w_highmin     625
+  #define w_highmax     950
+  #define w_totalperiod 1250
+#endif
+
+// SPI bit rate targeted, four SPI bits per WS2812 bit
+#define w_spi_rate      ((4 * 1000000000UL) / w_totalperiod)
+
+#if F_CPU < 2 * w_spi_rate
+   #error "ws2812_avr_usart: Sorry, the clock speed is too low. Did you set F_CPU correctly?"
+#endif
+
+// UBRR values of the SPI bit rates right above and right below the targeted rate
+#define w_ubrr_fast     (F_CPU / (2 * w_spi_rate) - 1)
+#define w_ubrr_slow     (w_ubrr_fast + 1)
+
+// Duration of one SPI bit at the provided UBRR value, which equals the "0" pulse, in ns
+#define w_bit_ns(ubrr)  ((2 * ((ubrr) + 1) * 1000000UL) / (F_CPU / 1000))
+
+// Checks if a "1" of high_bits SPI bits at the provided UBRR value meets the timing
+#define w_fits(ubrr, high_bits) \
+        (w_bit_ns(ubrr) <= w_lowmax && \
+         (high_bits) * w_bit_ns(ubrr) >= w_highmin && \
+         (high_bits) * w_bit_ns(ubrr) <= w_highmax && \
+         4 * w_bit_ns(ubrr) + 100 >= w_totalperiod)
+
+// SPI encoding of a '1', preferably `1100`, or `1110` if the SPI bits are too short
+#if w_fits(w_ubrr_slow, 2)
+  #define w_ubrr        w_ubrr_slow
+  #define w_one         0xC
+#elif w_fits(w_ubrr_fast, 2)
+  #define w_ubrr        w_ubrr_fast
+  #define w_one         0xC
+#elif w_fits(w_ubrr_fast, 3)
+  #define w_ubrr        w_ubrr_fast
+  #define w_one         0xE
+#elif w_fits(w_ubrr_slow, 3)
+  #define w_ubrr        w_ubrr_slow
+  #define w_one         0xE
+#else
+   #error "ws2812_avr_usart: Sorry, the WS2812 timing cannot be met with the current F_CPU. Try selecting the timing profile of your WS2812 devices."
+#endif
+
+#define w_spi_bit_ns    w_bit_ns(w_ubrr)
+
+// Time for the byte still held in the transmit buffer to be shifted out once a transmission returns, in us
+#define w_pending_us       ((8 * w_spi_bit_ns) / 1000)
+
+// USART register offsets relative to UCSRnA
+#define w_ucsra 0
+#define w_ucsrb 1
+#define w_ucsrc 2
+#define w_ubrrl 4
+#define w_ubrrh 5
+#define w_udr   6
+
+// USART register bits
+#define w_txc   6       ///< UCSRnA: Transmit complete
+#define w_udre  5       ///< UCSRnA: Data register empty
+#define w_txen  3       ///< UCSRnB: Transmitter enable
+#define w_mspim 0xC0    ///< UCSRnC: UMSELn1 and UMSELn0 set for Master SPI mode, MSB first
+
+/*
+ * SPI encoding of every bit pair, where a '0' is encoded as `1000` and a '1' as w_one.
+ */
+static const uint8_t _ws2812_pair_enc[4] = { 0x88, 0x80 | w_one, (w_one << 4) | 0x08, (w_one << 4) | w_one };
+
+// Refer to header for documentation
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
+{
+        dev->usart = cfg->usart;
+        dev->rst_time_us = cfg->rst_time_us;
+        dev->brightness = 255;
+        dev->lut = NULL;
+        dev->now_us = NULL;
+#ifdef WS2812_STATS
+        dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+        dev->power = NULL;
+        dev->n_pins = 1;
+#endif
+        dev->rst_pending = false;
+        dev->busy = false;
+        dev->prep = false;
+
+        // Initialization sequence according to the MSPIM section of the datasheet
+        dev->usart[w_ubrrl] = 0;
+        dev->usart[w_ubrrh] = 0;
+        *cfg->xck_ddr |= (1 << cfg->xck_pin);
+        dev->usart[w_ucsrc] = w_mspim;
+        dev->usart[w_ucsrb] = (1 << w_txen);
+        dev->usart[w_ubrrl] = w_ubrr & 0xFF;
+        dev->usart[w_ubrrh] = w_ubrr >> 8;
+
+        _ws2812_get_rgbmap(&dev->rgbmap, cfg->order);
+
+        return 0;
+}
+
+// Refer to header for documentation
+void ws2812_prep_tx(ws2812 *dev)
+{
+        if (dev->prep == false) {
+                _ws2812_finish_rst(dev);
+                dev->prep = true;
+        }
+}
+
+/**
+ * @brief Waits for all bytes written to the USART to be shifted out.
+ */
+static void ws2812_flush(ws2812 *dev)
+{
+        if (dev->busy == true) {
+                while (!(dev->usart[w_ucsra] & (1 << w_txc)));
+                dev->busy = false;
+        }
+}
+
+// Refer to header for documentation
+void ws2812_wait_rst(ws2812 *dev)
+{
+        // The reset only begins once the last byte has been shifted out
+        ws2812_flush(dev);
+        for (uint16_t i = 0; i < dev->rst_time_us; i++)
+                _delay_us(1);
+}
+
+/**
+ * @brief Writes a byte into the transmit buffer of the USART.
+ *
+ * The following function waits for the transmit buffer to be empty and writes the
+ * provided byte into it. The transmit complete flag is cleared before the write, so that
+ * it only gets set once the byte has been shifted out.
+ */
+static inline void ws2812_put(ws2812 *dev, uint8_t b)
+{
+        while (!(dev->usart[w_ucsra] & (1 << w_udre)));
+        dev->usart[w_ucsra] = (1 << w_txc);
+        dev->usart[w_udr] = b;
+}
+
+/**
+ * @brief Encodes and transmits a single color byte.
+ *
+ * The following function corrects the color byte by the LUT and brightness
+ * of the device, and transmits its 32 bit SPI encoding as four bytes.
+ */
+static void ws2812_tx_byte(ws2812 *dev, uint8_t c)
+{
+        c = _ws2812_correct(dev, c);
+
+        ws2812_put(dev, _ws2812_pair_enc[c >> 6]);
+        ws2812_put(dev, _ws2812_pair_enc[(c >> 4) & 0x03]);
+        ws2812_put(dev, _ws2812_pair_enc[(c >> 2) & 0x03]);
+        ws2812_put(dev, _ws2812_pair_enc[c & 0x03]);
+
+        dev->busy = true;
+}
+
+/**
+ * @brief Transmits a single RGB value in the color order of the device.
+ */
+static inline void ws2812_tx_pxl(ws2812 *dev, const ws2812_rgb *pxl)
+{
+        const uint8_t *c = (const uint8_t *) pxl;
+
+        ws2812_tx_byte(dev, c[dev->rgbmap[0]]);
+        ws2812_tx_byte(dev, c[dev->rgbmap[1]]);
+        ws2812_tx_byte(dev, c[dev->rgbmap[2]]);
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_leds; i++) {
+                ws2812_tx_pxl(dev, &leds[i]);
+                _ws2812_power_pxls(dev, &leds[i], 1);
+        }
+
+        _ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), w_pending_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
+{
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                ws2812_rgb pxl = gen(i, ctx);
+                ws2812_tx_pxl(dev, &pxl);
+                _ws2812_power_pxls(dev, &pxl, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), w_pending_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                       const ws2812_rgb *palette, size_t n_pxls)
+{
+        if (bits_per_index != 1 && bits_per_index != 2 &&
+            bits_per_index != 4 && bits_per_index != 8)
+                return;
+
+        uint8_t shift = 8 - bits_per_index;
+        uint8_t per_byte = 8 / bits_per_index;
+        uint8_t remaining = 0;
+        uint8_t cur = 0;
+
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                if (remaining == 0) {
+                        cur = *indices++;
+                        remaining = per_byte;
+                }
+
+                const uint8_t *c = (const uint8_t *) &palette[cur >> shift];
+
+                // Palette entries are expected in the color order of the device
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++)
+                        ws2812_tx_byte(dev, c[j]);
+
+                _ws2812_power_pxls(dev, (const ws2812_rgb *) c, 1);
+
+                cur <<= bits_per_index;
+                remaining--;
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), w_pending_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++)
+                ws2812_tx_pxl(dev, &color);
+
+        _ws2812_power_fill(dev, color, n_pxls);
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), w_pending_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+        for (size_t i = 0; i < n_runs; i++)
+                ws2812_tx_fill(dev, runs[i].color, runs[i].n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_bytes; i++)
+                ws2812_tx_byte(dev, bytes[i]);
+
+        _ws2812_power_bytes(dev, bytes, n_bytes);
+        _ws2812_stats_end(dev, n_bytes, w_pending_us);
+}
+
+// Refer to header for documentation
+size_t ws2812_encode(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls, void *buf, size_t buf_size)
+{
+        size_t n_bytes = WS2812_ENCODED_SIZE(n_pxls);
+        uint8_t *enc = (uint8_t *) buf;
+
+        if (buf_size < n_bytes)
+                return 0;
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                const uint8_t *c = (const uint8_t *) &pxls[i];
+
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++) {
+                        uint8_t b = _ws2812_correct(dev, c[dev->rgbmap[j]]);
+
+                        *enc++ = _ws2812_pair_enc[b >> 6];
+                        *enc++ = _ws2812_pair_enc[(b >> 4) & 0x03];
+                        *enc++ = _ws2812_pair_enc[(b >> 2) & 0x03];
+                        *enc++ = _ws2812_pair_enc[b & 0x03];
+                }
+        }
+
+        return n_bytes;
+}
+
+// Refer to header for documentation
+void ws2812_tx_encoded(ws2812 *dev, const void *buf, size_t n_bytes)
+{
+        const uint8_t *enc = (const uint8_t *) buf;
+
+        if (n_bytes == 0)
+                return;
+
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_bytes; i++)
+                ws2812_put(dev, enc[i]);
+
+        dev->busy = true;
+
+        _ws2812_stats_end(dev, n_bytes / 4, w_pending_us);
+}
+
+// Refer to header for documentation
+void _ws2812_release_tx(ws2812 *dev)
+{
+        ws2812_flush(dev);
+        dev->prep = false;
+}
+
+// Refer to header for documentation
+void ws2812_close_tx(ws2812 *dev)
+{
+        if (dev->prep == true) {
+                _ws2812_release_tx(dev);
+                _ws2812_begin_rst(dev);
+        }
+}
+
+#endif
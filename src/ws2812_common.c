@@ -31,6 +31,14 @@
 
 #include <ws2812.h>
 
+#if defined(WS2812_TARGET_PLATFORM_AVR) || defined(WS2812_TARGET_PLATFORM_ARDUINO_AVR) || \
+    defined(WS2812_TARGET_PLATFORM_AVR_USART)
+#include <avr/pgmspace.h>
+#define _ws2812_lut_read(lut, c) pgm_read_byte(&(lut)[c])
+#else
+#define _ws2812_lut_read(lut, c) ((lut)[c])
+#endif
+
 // RGB maps
 const static uint8_t ws2812_order_rgb[3] = { 0, 1, 2 };
 const static uint8_t ws2812_order_rbg[3] = { 0, 2, 1 };
@@ -62,4 +70,570 @@ void _ws2812_get_rgbmap(uint8_t (*rgbmap)[3], ws2812_order order)
                         memcpy(rgbmap, ws2812_order_rgb, 3);
                         break;
         }
-}
\ No newline at end of file
+}
+
+// Refer to header for documentation
+uint8_t _ws2812_correct(ws2812 *dev, uint8_t c)
+{
+        if (dev->lut != NULL)
+                c = _ws2812_lut_read(dev->lut, c);
+
+        if (dev->brightness == 255)
+                return c;
+
+        return ((uint16_t) c * (dev->brightness + 1)) >> 8;
+}
+
+// Refer to header for documentation
+void _ws2812_correct_lanes(ws2812 *dev, ws2812_rgb *lanes[], uint8_t n_lanes, uint8_t *v)
+{
+        const uint8_t *lut = dev->lut;
+        uint8_t scale = dev->brightness + 1; // 0 for full brightness
+        uint16_t sum = 0;
+
+        for (uint8_t l = 0; l < n_lanes; l++) {
+                const uint8_t *c = (const uint8_t *) lanes[l];
+
+                // Lanes without RGB values are transmitted as 0
+                if (c == NULL) {
+                        v[l] = v[n_lanes + l] = v[2 * n_lanes + l] = 0;
+                        continue;
+                }
+
+                lanes[l]++;
+
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++) {
+                        uint8_t b = c[dev->rgbmap[j]];
+
+                        if (lut != NULL)
+                                b = _ws2812_lut_read(lut, b);
+
+                        sum += b;
+
+                        if (scale)
+                                b = ((uint16_t) b * scale) >> 8;
+
+                        v[j * n_lanes + l] = b;
+                }
+        }
+
+#ifdef WS2812_POWER
+        // Every lane is output on a single data pin
+        if (dev->power != NULL)
+                dev->power->_sum += sum;
+#else
+        (void) sum;
+#endif
+}
+
+// Refer to header for documentation
+void ws2812_set_brightness(ws2812 *dev, uint8_t brightness)
+{
+#ifdef WS2812_POWER
+        if (dev->power != NULL) {
+                dev->power->brightness = brightness;
+
+                // Raised once the limiter has seen the next frame
+                if (brightness > dev->brightness)
+                        return;
+        }
+#endif
+        dev->brightness = brightness;
+}
+
+// Refer to header for documentation
+void ws2812_set_lut(ws2812 *dev, const uint8_t *lut)
+{
+        dev->lut = lut;
+}
+
+// Refer to header for documentation
+void ws2812_set_timer(ws2812 *dev, uint16_t (*now_us)(void))
+{
+        _ws2812_finish_rst(dev);
+        dev->now_us = now_us;
+}
+
+#if defined(WS2812_TARGET_PLATFORM_AVR) || defined(WS2812_TARGET_PLATFORM_ARDUINO_AVR) || \
+    defined(WS2812_TARGET_PLATFORM_STM8S)
+// Refer to header for documentation
+void ws2812_set_irq(ws2812 *dev, ws2812_irq irq, uint8_t n_pxls)
+{
+        dev->irq = irq;
+        dev->irq_pxls = n_pxls ? n_pxls : 1;
+}
+#endif
+
+#ifdef WS2812_STATS
+// Refer to header for documentation
+void ws2812_set_stats(ws2812 *dev, ws2812_stats *stats, uint16_t late_us)
+{
+        if (stats != NULL) {
+                memset(stats, 0, sizeof(*stats));
+                stats->late_us = late_us;
+        }
+
+        dev->stats = stats;
+}
+
+/**
+ * @brief Records a gap of the current frame in the stats of the device.
+ */
+static void _ws2812_stats_gap(ws2812_stats *s, uint16_t gap)
+{
+        if (gap > s->max_gap_us)
+                s->max_gap_us = gap;
+
+        if (gap > s->late_us && s->n_late != UINT16_MAX)
+                s->n_late++;
+}
+
+// Refer to header for documentation
+void _ws2812_stats_begin(ws2812 *dev)
+{
+        ws2812_stats *s = dev->stats;
+
+        if (s == NULL || dev->now_us == NULL)
+                return;
+
+        uint16_t now = dev->now_us();
+
+        if (s->_active == false) {
+                s->_start = now;
+                s->_n_bytes = 0;
+                return;
+        }
+
+        uint16_t gap = now - s->_end;
+
+        // The bytes of the last call may not have been shifted out yet
+        if ((int16_t) gap <= 0)
+                return;
+
+        _ws2812_stats_gap(s, gap);
+}
+
+// Refer to header for documentation
+void _ws2812_stats_end(ws2812 *dev, size_t n_bytes, uint16_t pending_us)
+{
+        ws2812_stats *s = dev->stats;
+
+        if (s == NULL || dev->now_us == NULL)
+                return;
+
+        s->_end = dev->now_us() + pending_us;
+        s->_n_bytes += n_bytes;
+        s->_active = true;
+}
+
+// Refer to header for documentation
+void _ws2812_stats_pause(ws2812 *dev)
+{
+        ws2812_stats *s = dev->stats;
+
+        if (s == NULL || dev->now_us == NULL)
+                return;
+
+        s->_pause = dev->now_us();
+}
+
+// Refer to header for documentation
+void _ws2812_stats_resume(ws2812 *dev)
+{
+        ws2812_stats *s = dev->stats;
+
+        if (s == NULL || dev->now_us == NULL)
+                return;
+
+        _ws2812_stats_gap(s, dev->now_us() - s->_pause);
+}
+
+/**
+ * @brief Closes the current frame in the stats of the device, if any.
+ */
+static void _ws2812_stats_close(ws2812 *dev)
+{
+        ws2812_stats *s = dev->stats;
+
+        if (s == NULL || dev->now_us == NULL || s->_active == false)
+                return;
+
+        s->frame_us = dev->now_us() - s->_start;
+        s->n_bytes = s->_n_bytes;
+        s->_active = false;
+}
+#endif
+
+#ifdef WS2812_POWER
+// Refer to header for documentation
+void ws2812_set_power(ws2812 *dev, ws2812_power *power, uint16_t budget_ma)
+{
+        if (power != NULL) {
+                // Saved ahead of the memset, as the same power struct may be attached again
+                uint8_t brightness = (dev->power != NULL) ? dev->power->brightness : dev->brightness;
+
+                memset(power, 0, sizeof(*power));
+                power->budget_ma = budget_ma;
+                power->brightness = brightness;
+        }
+
+        dev->power = power;
+}
+
+/**
+ * @brief Returns the sum of the LUT corrected color bytes of an RGB value.
+ */
+static uint16_t _ws2812_power_sum(ws2812 *dev, const ws2812_rgb *pxl)
+{
+        const uint8_t *c = (const uint8_t *) pxl;
+
+        if (dev->lut == NULL)
+                return (uint16_t) c[0] + c[1] + c[2];
+
+        return (uint16_t) _ws2812_lut_read(dev->lut, c[0]) +
+               _ws2812_lut_read(dev->lut, c[1]) +
+               _ws2812_lut_read(dev->lut, c[2]);
+}
+
+// Refer to header for documentation
+void _ws2812_power_pxls(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls)
+{
+        if (dev->power == NULL)
+                return;
+
+        uint32_t sum = 0;
+
+        for (size_t i = 0; i < n_pxls; i++)
+                sum += _ws2812_power_sum(dev, &pxls[i]);
+
+        // Every data pin outputs the same colors
+        dev->power->_sum += sum * dev->n_pins;
+}
+
+// Refer to header for documentation
+void _ws2812_power_add(ws2812 *dev, uint32_t sum)
+{
+        if (dev->power == NULL)
+                return;
+
+        // Every data pin outputs the same colors
+        dev->power->_sum += sum * dev->n_pins;
+}
+
+// Refer to header for documentation
+void _ws2812_power_bytes(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+        if (dev->power == NULL)
+                return;
+
+        uint32_t sum = 0;
+
+        for (size_t i = 0; i < n_bytes; i++)
+                sum += (dev->lut == NULL) ? bytes[i] : _ws2812_lut_read(dev->lut, bytes[i]);
+
+        dev->power->_sum += sum * dev->n_pins;
+}
+
+// Refer to header for documentation
+void _ws2812_power_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                           const ws2812_rgb *palette, size_t n_pxls)
+{
+        if (dev->power == NULL)
+                return;
+
+        uint8_t per_byte = 8 / bits_per_index;
+        uint32_t sum = 0;
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                uint8_t idx = indices[i / per_byte];
+
+                idx <<= (i % per_byte) * bits_per_index;
+                idx >>= 8 - bits_per_index;
+
+                sum += _ws2812_power_sum(dev, &palette[idx]);
+        }
+
+        dev->power->_sum += sum * dev->n_pins;
+}
+
+// Refer to header for documentation
+void _ws2812_power_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+        if (dev->power == NULL)
+                return;
+
+        dev->power->_sum += (uint32_t) _ws2812_power_sum(dev, &color) * n_pxls * dev->n_pins;
+}
+
+// Refer to header for documentation
+void _ws2812_power_lanes(ws2812 *dev, ws2812_rgb *lanes[], uint8_t n_lanes, size_t n_pxls)
+{
+        if (dev->power == NULL)
+                return;
+
+        for (uint8_t l = 0; l < n_lanes; l++) {
+                if (lanes[l] == NULL)
+                        continue;
+
+                for (size_t i = 0; i < n_pxls; i++)
+                        dev->power->_sum += _ws2812_power_sum(dev, &lanes[l][i]);
+        }
+}
+
+// Refer to header for documentation
+void _ws2812_power_close(ws2812 *dev)
+{
+        ws2812_power *p = dev->power;
+
+        if (p == NULL)
+                return;
+
+        // Draw at full brightness, and at the brightness the frame has been transmitted with
+        uint32_t full_ma = p->_sum * WS2812_MA_PER_CHANNEL / 255;
+        uint32_t draw_ma = (full_ma * (dev->brightness + 1)) >> 8;
+        uint8_t brightness = p->brightness;
+
+        p->draw_ma = (draw_ma < UINT16_MAX) ? draw_ma : UINT16_MAX;
+        p->_sum = 0;
+
+        // Highest brightness at which a frame of equal content stays within the budget
+        if (((full_ma * (brightness + 1)) >> 8) > p->budget_ma) {
+                uint32_t scale = ((uint32_t) p->budget_ma << 8) / full_ma;
+                brightness = scale ? scale - 1 : 0;
+        }
+
+        dev->brightness = brightness;
+}
+#endif
+
+// Refer to header for documentation
+void _ws2812_begin_rst(ws2812 *dev)
+{
+#ifdef WS2812_STATS
+        // The frame ends where the reset begins
+        _ws2812_stats_close(dev);
+#endif
+        _ws2812_power_close(dev);
+
+        if (dev->now_us == NULL) {
+                ws2812_wait_rst(dev);
+                return;
+        }
+
+        dev->rst_start = dev->now_us();
+        dev->rst_pending = true;
+}
+
+// Refer to header for documentation
+void _ws2812_finish_rst(ws2812 *dev)
+{
+        if (dev->rst_pending == false)
+                return;
+
+        while ((uint16_t) (dev->now_us() - dev->rst_start) < dev->rst_time_us);
+        dev->rst_pending = false;
+}
+
+// Refer to header for documentation
+void ws2812_map_rgb(ws2812 *dev, ws2812_rgb *pxls, size_t n_pxls)
+{
+        for (size_t i = 0; i < n_pxls; i++) {
+                uint8_t *pxl = (uint8_t *) &(pxls[i]);
+                uint8_t tmp[3];
+
+                for (uint8_t j = 0; j < sizeof(dev->rgbmap); j++)
+                        tmp[j] = pxl[dev->rgbmap[j]];
+
+                memcpy(pxl, tmp, sizeof(tmp));
+        }
+}
+
+// Refer to header for documentation
+void ws2812_tx_multi(ws2812 *devs[], ws2812_rgb *pxls[], size_t n_pxls[], uint8_t n_devs)
+{
+        if (n_devs == 0)
+                return;
+
+        ws2812 *rst_dev = NULL; // Blocking device with longest reset time
+
+        for (uint8_t i = 0; i < n_devs; i++) {
+                ws2812_prep_tx(devs[i]);
+                ws2812_tx(devs[i], pxls[i], n_pxls[i]);
+                _ws2812_release_tx(devs[i]);
+
+                // Devices with a timer track their reset on their own
+                if (devs[i]->now_us != NULL) {
+                        _ws2812_begin_rst(devs[i]);
+                        continue;
+                }
+
+                _ws2812_power_close(devs[i]);
+
+                if (rst_dev == NULL || devs[i]->rst_time_us > rst_dev->rst_time_us)
+                        rst_dev = devs[i];
+        }
+
+        if (rst_dev != NULL)
+                ws2812_wait_rst(rst_dev);
+}
+
+// Refer to header for documentation
+void ws2812_frame_init(ws2812_frame *frm, ws2812_rgb *pxls, size_t n_pxls)
+{
+        frm->pxls = pxls;
+        frm->n_pxls = n_pxls;
+        frm->n_dirty = n_pxls;
+}
+
+// Refer to header for documentation
+void ws2812_frame_set(ws2812_frame *frm, size_t idx, ws2812_rgb color)
+{
+        if (idx >= frm->n_pxls)
+                return;
+
+        if (memcmp(&frm->pxls[idx], &color, sizeof(color)) == 0)
+                return;
+
+        frm->pxls[idx] = color;
+
+        if (idx >= frm->n_dirty)
+                frm->n_dirty = idx + 1;
+}
+
+// Refer to header for documentation
+void ws2812_frame_mark(ws2812_frame *frm, size_t idx)
+{
+        if (idx >= frm->n_pxls)
+                idx = frm->n_pxls - 1;
+
+        if (idx >= frm->n_dirty)
+                frm->n_dirty = idx + 1;
+}
+
+// Refer to header for documentation
+void ws2812_frame_refresh(ws2812 *dev, ws2812_frame *frm)
+{
+        if (frm->n_dirty == 0)
+                return;
+
+        ws2812_prep_tx(dev);
+        ws2812_tx(dev, frm->pxls, frm->n_dirty);
+        ws2812_close_tx(dev);
+
+        frm->n_dirty = 0;
+}
+
+// Refer to header for documentation
+const ws2812_rgb *_ws2812_layout_row(const ws2812_layout *layout, const ws2812_rgb *pxls, uint16_t i, bool *rev)
+{
+        uint16_t h = layout->height;
+        uint8_t flags = layout->flags;
+        bool mirrored = false;
+
+        // The mirrored copy retraces the chain, from its last row to its first row
+        if (i >= h) {
+                if ((flags & WS2812_LAYOUT_MIRRORED) == 0 || i >= 2 * h)
+                        return NULL;
+
+                i = 2 * h - 1 - i;
+                mirrored = true;
+        }
+
+        uint16_t y = (flags & WS2812_LAYOUT_FLIPPED) ? h - 1 - i : i;
+
+        *rev = ((flags & WS2812_LAYOUT_REVERSED) != 0) != mirrored;
+
+        if ((flags & WS2812_LAYOUT_SERPENTINE) && (i & 1))
+                *rev = !*rev;
+
+        return &pxls[(size_t) y * layout->width];
+}
+
+/**
+ * @brief Generator returning the RGB values of a row from its last to its first LED.
+ *
+ * The context points past the last RGB value of the row.
+ */
+static ws2812_rgb _ws2812_layout_rev(size_t idx, void *ctx)
+{
+        return ((const ws2812_rgb *) ctx)[-1 - (ptrdiff_t) idx];
+}
+
+// Refer to header for documentation
+void _ws2812_tx_layout_rows(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls)
+{
+        uint16_t w = layout->width;
+        const ws2812_rgb *row;
+        bool rev;
+
+        for (uint16_t i = 0; (row = _ws2812_layout_row(layout, pxls, i, &rev)) != NULL; i++) {
+                if (rev)
+                        ws2812_tx_gen(dev, _ws2812_layout_rev, (void *) (row + w), w);
+                else
+                        ws2812_tx(dev, (ws2812_rgb *) row, w);
+        }
+}
+
+#if !defined(WS2812_TARGET_PLATFORM_AVR) && !defined(WS2812_TARGET_PLATFORM_ARDUINO_AVR) && \
+    !defined(WS2812_TARGET_PLATFORM_STM8S)
+// Refer to header for documentation
+void ws2812_tx_layout(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls)
+{
+        _ws2812_tx_layout_rows(dev, layout, pxls);
+}
+#endif
+
+// Refer to header for documentation
+void ws2812_sched_init(ws2812_sched *sched, ws2812_rgb *pxls, size_t n_pxls, uint8_t fps)
+{
+        sched->pxls = pxls;
+        sched->n_pxls = n_pxls;
+        sched->period_us = fps ? 1000000UL / fps : 0;
+        sched->frame = 0;
+        sched->n_missed = 0;
+}
+
+/**
+ * @brief Returns the time elapsed since the previous call in us.
+ */
+static uint16_t _ws2812_sched_elapsed(ws2812 *dev, uint16_t *last)
+{
+        uint16_t now = dev->now_us();
+        uint16_t elapsed = now - *last;
+
+        *last = now;
+        return elapsed;
+}
+
+// Refer to header for documentation
+void ws2812_sched_run(ws2812 *dev, ws2812_sched *sched, bool (*render)(ws2812_sched *sched, void *ctx), void *ctx)
+{
+        if (dev->now_us == NULL || sched->period_us == 0)
+                return;
+
+        uint16_t last = dev->now_us();
+        int32_t slack = sched->period_us; // Time left until the deadline of the frame being rendered
+
+        while (render(sched, ctx)) {
+                uint32_t n = 1; // Number of deadlines passed once the frame is transmitted
+
+                slack -= _ws2812_sched_elapsed(dev, &last);
+
+                if (slack < 0) {
+                        // Transmit the late frame right away and skip the deadlines that have passed
+                        n = (uint32_t) -slack / sched->period_us + 1;
+                        sched->n_missed = (n < (uint16_t) (UINT16_MAX - sched->n_missed)) ? sched->n_missed + n : UINT16_MAX;
+                } else {
+                        while (slack > 0)
+                                slack -= _ws2812_sched_elapsed(dev, &last);
+                }
+
+                // With a timer set, the reset elapses while the next frame is rendered
+                ws2812_prep_tx(dev);
+                ws2812_tx(dev, sched->pxls, sched->n_pxls);
+                ws2812_close_tx(dev);
+
+                sched->frame += n;
+                slack += (int32_t) (n * sched->period_us);
+        }
+}
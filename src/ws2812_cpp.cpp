@@ -46,6 +46,11 @@ void ws2812_cpp::tx(ws2812_rgb *leds, size_t n_leds)
         ws2812_tx(&_ws2812, leds, n_leds);
 }
 
+void ws2812_cpp::tx(const ws2812_layout *layout, const ws2812_rgb *leds)
+{
+        ws2812_tx_layout(&_ws2812, layout, leds);
+}
+
 void ws2812_cpp::wait_rst()
 {
         ws2812_wait_rst(&_ws2812);
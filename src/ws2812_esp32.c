@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_esp32.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Driver code for ESP32 chips using the RMT peripheral.
+ *
+ * The following file holds the Tiny-WS2812 library code to drive
+ * WS2812 devices on ESP32 chips through the RMT peripheral.
+ *
+ * Rather than bit-banging a GPIO, which would be stretched by WiFi and other interrupts,
+ * every WS2812 bit is translated into one RMT item (a high and a low duration), which is
+ * then played back by the RMT channel of the device. The RMT driver of the ESP-IDF only holds
+ * half a memory block worth of items at a time, and refills it from its interrupt through
+ * ws2812_translate(), hence frames of any size can be transmitted without encoding them into
+ * a buffer first. Each RMT channel operates independently, so multiple devices may transmit
+ * in parallel.
+ */
+
+#ifdef WS2812_TARGET_PLATFORM_ESP32
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <driver/rmt.h>
+#include <esp_rom_sys.h>
+#include <freertos/FreeRTOS.h>
+
+#include <ws2812.h>
+
+// Timing in ns, unless a timing profile has been selected (see ws2812_common.h)
+#ifdef WS2812_T0H_NS
+#define w_zeropulse   WS2812_T0H_NS
+#define w_onepulse    WS2812_T1H_NS
+#define w_totalperiod WS2812_PERIOD_NS
+#else
+#define w_zeropulse   350
+#define w_onepulse    900
+#define w_totalperiod 1250
+#endif
+
+// RMT ticks, with the 80 MHz APB clock divided by 2 (25ns per tick)
+#define w_clk_div     2
+#define w_tick_ns     25
+#define w_ticks(ns)   ((ns) / w_tick_ns)
+
+// Time for a color byte to be played back in us
+#define w_byte_us     ((8 * w_totalperiod) / 1000)
+
+// Types of data translated by ws2812_translate()
+#define _WS2812_SRC_PXLS    0   ///< RGB values, mapped to the color order of the device
+#define _WS2812_SRC_RAW     1   ///< Bytes, transmitted as they are
+#define _WS2812_SRC_FILL    2   ///< A single RGB value, repeated
+#define _WS2812_SRC_RLE     3   ///< Runs of RGB values
+#define _WS2812_SRC_INDEXED 4   ///< Palette indices
+#define _WS2812_SRC_GEN     5   ///< RGB values returned by a generator callback
+
+// RMT items of a '0' and a '1' bit
+static const rmt_item32_t _ws2812_zero = {{{ w_ticks(w_zeropulse), 1, w_ticks(w_totalperiod - w_zeropulse), 0 }}};
+static const rmt_item32_t _ws2812_one  = {{{ w_ticks(w_onepulse), 1, w_ticks(w_totalperiod - w_onepulse), 0 }}};
+
+/**
+ * @brief Returns the color byte at the provided position of the data being transmitted.
+ *
+ * The following function resolves the color byte at position pos of the data described by the
+ * src_ fields of the device, including the color order mapping, but excluding the LUT and brightness.
+ * Positions are guaranteed to be requested in ascending order, which the run-length encoded
+ * transmission relies on to advance its current run, and the generated transmission relies on
+ * to call the generator once per LED, as the first byte of the LED is requested.
+ */
+static uint8_t ws2812_src_byte(ws2812 *dev, size_t pos)
+{
+        size_t pxl = pos / sizeof(ws2812_rgb);
+        uint8_t j = pos % sizeof(ws2812_rgb);
+
+        switch (dev->src_type) {
+        case _WS2812_SRC_RAW:
+                return ((const uint8_t *) dev->src)[pos];
+        case _WS2812_SRC_FILL:
+                return ((const uint8_t *) &dev->src_color)[dev->rgbmap[j]];
+        case _WS2812_SRC_RLE: {
+                const ws2812_run *runs = (const ws2812_run *) dev->src;
+
+                while (pxl >= dev->src_run_end)
+                        dev->src_run_end += runs[++dev->src_run].n_pxls;
+
+                return ((const uint8_t *) &runs[dev->src_run].color)[dev->rgbmap[j]];
+        }
+        case _WS2812_SRC_INDEXED: {
+                uint8_t per_byte = 8 / dev->src_bits;
+                uint8_t idx = ((const uint8_t *) dev->src)[pxl / per_byte];
+
+                idx <<= (pxl % per_byte) * dev->src_bits;
+                idx >>= 8 - dev->src_bits;
+
+                // Palette entries are expected in the color order of the device
+                return ((const uint8_t *) &dev->src_palette[idx])[j];
+        }
+        case _WS2812_SRC_GEN:
+                if (pxl == dev->src_run) {
+                        dev->src_color = dev->src_gen(pxl, dev->src_ctx);
+                        dev->src_run++;
+
+                        // The caller blocks until the frame has been played back
+                        _ws2812_power_pxls(dev, &dev->src_color, 1);
+                }
+
+                return ((const uint8_t *) &dev->src_color)[dev->rgbmap[j]];
+        default:
+                return ((const uint8_t *) dev->src)[pxl * sizeof(ws2812_rgb) + dev->rgbmap[j]];
+        }
+}
+
+/**
+ * @brief Translates color bytes into RMT items.
+ *
+ * The following function is installed as the translator of the RMT channel and is called by the
+ * RMT driver, first when the transmission is started and then from the RMT interrupt, every time
+ * half of the RMT memory block has been played back. It translates as many complete color bytes as
+ * fit into wanted_num items, corrected by the LUT and brightness of the device.
+ *
+ * Rather than reading from src, the position of the next byte is derived from the remaining
+ * size, so that generated data (ex. fills and runs) can be translated as well.
+ */
+static void ws2812_translate(const void *src, rmt_item32_t *dest, size_t src_size,
+                             size_t wanted_num, size_t *translated_size, size_t *item_num)
+{
+        ws2812 *dev;
+        rmt_translator_get_context(item_num, (void **) &dev);
+
+        size_t start = dev->src_size - src_size;
+        size_t pos = start;
+        size_t n = 0;
+
+        while (n + 8 <= wanted_num && pos < dev->src_size) {
+                uint8_t c = _ws2812_correct(dev, ws2812_src_byte(dev, pos++));
+
+                for (uint8_t b = 0; b < 8; b++) {
+                        dest[n++] = (c & 0x80) ? _ws2812_one : _ws2812_zero;
+                        c <<= 1;
+                }
+        }
+
+        *translated_size = pos - start;
+        *item_num = n;
+}
+
+/**
+ * @brief Waits for the ongoing transmission of the device, if any, to be shifted out.
+ */
+static void ws2812_wait_async(ws2812 *dev)
+{
+        rmt_wait_tx_done(dev->channel, portMAX_DELAY);
+}
+
+/**
+ * @brief Starts the transmission of n_bytes color bytes, as described by the src_ fields of the device.
+ *
+ * The following function waits for the ongoing transmission of the device, if any, to finish,
+ * since the src_ fields are in use until then. The src_ fields, apart from src_size, must thus
+ * be set after calling ws2812_wait_async().
+ */
+static void ws2812_start(ws2812 *dev, size_t n_bytes, bool wait)
+{
+        if (n_bytes == 0)
+                return;
+
+        dev->src_size = n_bytes;
+
+        _ws2812_stats_begin(dev);
+
+        // The source pointer is never dereferenced, see ws2812_translate()
+        rmt_write_sample(dev->channel, (const uint8_t *) dev, n_bytes, wait);
+
+        // The items of a background transmission are yet to be played back
+        _ws2812_stats_end(dev, n_bytes, wait ? 0 : n_bytes * w_byte_us);
+}
+
+// Refer to header for documentation
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
+{
+        if (cfg->n_dev == 0)
+                return 1; // No devices to be driven!
+
+        rmt_config_t rmt_cfg = RMT_DEFAULT_CONFIG_TX((gpio_num_t) cfg->pins[0], cfg->channel);
+        rmt_cfg.clk_div = w_clk_div;
+
+        if (rmt_config(&rmt_cfg) != ESP_OK ||
+            rmt_driver_install(cfg->channel, 0, 0) != ESP_OK)
+                return 2; // RMT channel could not be configured!
+
+        // Route the channel to the remaining pins
+        for (uint8_t i = 1; i < cfg->n_dev; i++)
+                rmt_set_gpio(cfg->channel, RMT_MODE_TX, (gpio_num_t) cfg->pins[i], false);
+
+        rmt_translator_init(cfg->channel, ws2812_translate);
+        rmt_translator_set_context(cfg->channel, dev);
+
+        dev->channel = cfg->channel;
+        dev->rst_time_us = cfg->rst_time_us;
+        dev->prep = false;
+        dev->brightness = 255;
+        dev->lut = NULL;
+        dev->now_us = NULL;
+#ifdef WS2812_STATS
+        dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+        dev->power = NULL;
+        dev->n_pins = cfg->n_dev;
+#endif
+        dev->rst_pending = false;
+
+        _ws2812_get_rgbmap(&dev->rgbmap, cfg->order);
+
+        return 0;
+}
+
+// Refer to header for documentation
+void ws2812_prep_tx(ws2812 *dev)
+{
+        if (dev->prep == false) {
+                _ws2812_finish_rst(dev);
+                dev->prep = true;
+        }
+}
+
+// Refer to header for documentation
+void ws2812_wait_rst(ws2812 *dev)
+{
+        // The reset only begins once the last item has been played back
+        ws2812_wait_async(dev);
+        esp_rom_delay_us(dev->rst_time_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls)
+{
+        ws2812_wait_async(dev);
+
+        dev->src_type = _WS2812_SRC_PXLS;
+        dev->src = pxls;
+        ws2812_start(dev, n_pxls * sizeof(ws2812_rgb), false);
+
+        // Accounted while the RMT plays back the frame
+        _ws2812_power_pxls(dev, pxls, n_pxls);
+}
+
+// Refer to header for documentation
+bool ws2812_tx_done(ws2812 *dev)
+{
+        return rmt_wait_tx_done(dev->channel, 0) == ESP_OK;
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+        ws2812_tx_async(dev, leds, n_leds);
+        ws2812_wait_async(dev);
+}
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
+{
+        ws2812_wait_async(dev);
+
+        // The generator is called by the translator, so that the LEDs are not separated by gaps
+        dev->src_type = _WS2812_SRC_GEN;
+        dev->src_gen = gen;
+        dev->src_ctx = ctx;
+        dev->src_run = 0;
+        ws2812_start(dev, n_pxls * sizeof(ws2812_rgb), true);
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                       const ws2812_rgb *palette, size_t n_pxls)
+{
+        if (bits_per_index != 1 && bits_per_index != 2 &&
+            bits_per_index != 4 && bits_per_index != 8)
+                return;
+
+        ws2812_wait_async(dev);
+
+        dev->src_type = _WS2812_SRC_INDEXED;
+        dev->src = indices;
+        dev->src_palette = palette;
+        dev->src_bits = bits_per_index;
+        ws2812_start(dev, n_pxls * sizeof(ws2812_rgb), true);
+        _ws2812_power_indexed(dev, indices, bits_per_index, palette, n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+        ws2812_wait_async(dev);
+
+        dev->src_type = _WS2812_SRC_FILL;
+        dev->src_color = color;
+        ws2812_start(dev, n_pxls * sizeof(ws2812_rgb), true);
+        _ws2812_power_fill(dev, color, n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+        size_t n_pxls = 0;
+
+        for (size_t i = 0; i < n_runs; i++) {
+                n_pxls += runs[i].n_pxls;
+                _ws2812_power_fill(dev, runs[i].color, runs[i].n_pxls);
+        }
+
+        ws2812_wait_async(dev);
+
+        // All runs are transmitted at once, so that they are not separated by gaps
+        dev->src_type = _WS2812_SRC_RLE;
+        dev->src = runs;
+        dev->src_run = 0;
+        dev->src_run_end = n_runs ? runs[0].n_pxls : 0;
+        ws2812_start(dev, n_pxls * sizeof(ws2812_rgb), true);
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+        ws2812_wait_async(dev);
+
+        dev->src_type = _WS2812_SRC_RAW;
+        dev->src = bytes;
+        ws2812_start(dev, n_bytes, true);
+        _ws2812_power_bytes(dev, bytes, n_bytes);
+}
+
+// Refer to header for documentation
+size_t ws2812_encode(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls, void *buf, size_t buf_size)
+{
+        size_t n_bytes = WS2812_ENCODED_SIZE(n_pxls);
+        rmt_item32_t *items = (rmt_item32_t *) buf;
+
+        if (buf_size < n_bytes)
+                return 0;
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                const uint8_t *c = (const uint8_t *) &pxls[i];
+
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++) {
+                        uint8_t b = _ws2812_correct(dev, c[dev->rgbmap[j]]);
+
+                        for (uint8_t k = 0; k < 8; k++) {
+                                *items++ = (b & 0x80) ? _ws2812_one : _ws2812_zero;
+                                b <<= 1;
+                        }
+                }
+        }
+
+        return n_bytes;
+}
+
+// Refer to header for documentation
+void ws2812_tx_encoded(ws2812 *dev, const void *buf, size_t n_bytes)
+{
+        size_t n_items = n_bytes / sizeof(rmt_item32_t);
+
+        ws2812_wait_async(dev);
+
+        if (n_items == 0)
+                return;
+
+        // The items are copied into the RMT memory by the RMT interrupt, without being translated
+        _ws2812_stats_begin(dev);
+        rmt_write_items(dev->channel, (const rmt_item32_t *) buf, n_items, false);
+        _ws2812_stats_end(dev, n_items / 8, n_items / 8 * w_byte_us);
+}
+
+// Refer to header for documentation
+void _ws2812_release_tx(ws2812 *dev)
+{
+        ws2812_wait_async(dev);
+        dev->prep = false;
+}
+
+// Refer to header for documentation
+void ws2812_close_tx(ws2812 *dev)
+{
+        if (dev->prep == true) {
+                _ws2812_release_tx(dev);
+                _ws2812_begin_rst(dev);
+        }
+}
+
+#endif
@@ -0,0 +1,594 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_rp2040.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Driver code for RP2040 chips using the PIO.
+ *
+ * The following file holds the Tiny-WS2812 library code to drive
+ * WS2812 devices on RP2040 chips through a PIO state machine.
+ *
+ * The waveform is generated by one of two PIO programs, both clocked at 8 MHz,
+ * that is 10 PIO cycles per WS2812 bit:
+ *      - Devices with a single pin run the side-set program, which shifts out one
+ *        color byte per FIFO word, MSB first. Since byte writes are replicated across the
+ *        FIFO word, a DMA channel can feed the color bytes straight from memory.
+ *      - Devices with multiple pins run the parallel program, which outputs one bit slice
+ *        per bit slot, where bit n of the slice is written to the n-th pin above the lowest pin.
+ *        Four slices are packed into every FIFO word by the CPU.
+ *
+ * Both programs are loaded once per PIO block and shared by all devices on it.
+ */
+
+#ifdef WS2812_TARGET_PLATFORM_RP2040
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <hardware/pio.h>
+#include <hardware/dma.h>
+#include <hardware/clocks.h>
+#include <hardware/timer.h>
+
+#include <ws2812.h>
+
+// PIO cycles per WS2812 bit and the resulting PIO clock
+#define w_cycles_per_bit 10
+#define w_pio_hz         (800000 * w_cycles_per_bit)
+
+// Time for the output shift register to run dry once the TX FIFO is empty (one color byte)
+#define w_drain_us       10
+
+// Time for a color byte to be shifted out in us
+#define w_byte_us        10
+
+/*
+ * Side-set program, with T1 = 3, T2 = 4 and T3 = 3 cycles ('0': 375ns high, '1': 875ns high):
+ *
+ *      .side_set 1
+ *      .wrap_target
+ *      bitloop:
+ *              out x, 1        side 0 [T3 - 1] ; Side-set still takes place when instruction stalls
+ *              jmp !x do_zero  side 1 [T1 - 1] ; Branch on the bit we shifted out. Positive pulse
+ *      do_one:
+ *              jmp bitloop     side 1 [T2 - 1] ; Continue driving high, for a long pulse
+ *      do_zero:
+ *              nop             side 0 [T2 - 1] ; Or drive low, for a short pulse
+ *      .wrap
+ *
+ * Autopull is enabled with a threshold of 8 bits, shifting left.
+ */
+static const uint16_t _ws2812_sideset_instr[] = {
+        0x6221, //  0: out    x, 1            side 0 [2]
+        0x1223, //  1: jmp    !x, 3           side 1 [2]
+        0x1300, //  2: jmp    0               side 1 [3]
+        0xa342, //  3: nop                    side 0 [3]
+};
+
+static const struct pio_program _ws2812_sideset_program = {
+        .instructions = _ws2812_sideset_instr,
+        .length = 4,
+        .origin = -1,
+};
+
+/*
+ * Parallel program, with the same timing as the side-set program:
+ *
+ *      .wrap_target
+ *              out x, 8                        ; Fetch the bit slice
+ *              mov pins, !null [T1 - 1]        ; Rising edge on all pins
+ *              mov pins, x     [T2 - 1]        ; Falling edge of '0' pins
+ *              mov pins, null  [T3 - 2]        ; Falling edge of '1' pins
+ *      .wrap
+ *
+ * Autopull is enabled with a threshold of 32 bits, shifting left.
+ */
+static const uint16_t _ws2812_parallel_instr[] = {
+        0x6028, //  0: out    x, 8
+        0xa20b, //  1: mov    pins, !null     [2]
+        0xa301, //  2: mov    pins, x         [3]
+        0xa103, //  3: mov    pins, null      [1]
+};
+
+static const struct pio_program _ws2812_parallel_program = {
+        .instructions = _ws2812_parallel_instr,
+        .length = 4,
+        .origin = -1,
+};
+
+// Offsets of the loaded programs per PIO block (-1 = not loaded)
+static int8_t _ws2812_sideset_offset[2] = { -1, -1 };
+static int8_t _ws2812_parallel_offset[2] = { -1, -1 };
+
+/**
+ * @brief Loads a program into the provided PIO block, unless it has been loaded already.
+ *
+ * @return Offset of the program, or -1 if there is no space left in the PIO block.
+ */
+static int8_t ws2812_load(PIO pio, const struct pio_program *program, int8_t *offset)
+{
+        uint8_t idx = pio_get_index(pio);
+
+        if (offset[idx] < 0 && pio_can_add_program(pio, program))
+                offset[idx] = pio_add_program(pio, program);
+
+        return offset[idx];
+}
+
+/**
+ * @brief Waits for all color bytes, including the ones of a background transmission, to be shifted out.
+ */
+static void ws2812_flush(ws2812 *dev)
+{
+        if (dev->dma >= 0)
+                dma_channel_wait_for_finish_blocking(dev->dma);
+
+        while (!pio_sm_is_tx_fifo_empty(dev->pio, dev->sm));
+        busy_wait_us_32(w_drain_us);
+}
+
+#ifdef WS2812_STATS
+/**
+ * @brief Returns the time for the words left in the TX FIFO to be shifted out in us.
+ *
+ * Every word holds a color byte for devices with a single pin, and four bit slices
+ * (half a color byte) for devices with multiple pins.
+ */
+static uint16_t ws2812_pending_us(ws2812 *dev)
+{
+        uint16_t level = pio_sm_get_tx_fifo_level(dev->pio, dev->sm);
+
+        return dev->dma >= 0 ? level * w_byte_us : level * (w_byte_us / 2);
+}
+#endif
+
+/**
+ * @brief Waits for the background transmission, if any, to hand over its last byte.
+ */
+static inline void ws2812_wait_async(ws2812 *dev)
+{
+        if (dev->dma >= 0)
+                dma_channel_wait_for_finish_blocking(dev->dma);
+}
+
+/**
+ * @brief Transmits a single color byte through the CPU.
+ *
+ * The following function corrects the color byte by the LUT and brightness of the device,
+ * and writes it into the TX FIFO. Devices with multiple pins receive the byte as eight
+ * bit slices, with every bit being output on all pins.
+ */
+static void ws2812_tx_byte(ws2812 *dev, uint8_t c)
+{
+        c = _ws2812_correct(dev, c);
+
+        if (dev->dma >= 0) {
+                pio_sm_put_blocking(dev->pio, dev->sm, (uint32_t) c << 24);
+                return;
+        }
+
+        for (uint8_t w = 0; w < 2; w++) {
+                uint32_t slices = 0;
+
+                for (uint8_t b = 0; b < 4; b++) {
+                        slices = (slices << 8) | ((c & 0x80) ? dev->pin_msk : 0);
+                        c <<= 1;
+                }
+
+                pio_sm_put_blocking(dev->pio, dev->sm, slices);
+        }
+}
+
+/**
+ * @brief Transmits a single RGB value in the color order of the device through the CPU.
+ */
+static void ws2812_tx_pxl(ws2812 *dev, const ws2812_rgb *pxl)
+{
+        const uint8_t *c = (const uint8_t *) pxl;
+
+        ws2812_tx_byte(dev, c[dev->rgbmap[0]]);
+        ws2812_tx_byte(dev, c[dev->rgbmap[1]]);
+        ws2812_tx_byte(dev, c[dev->rgbmap[2]]);
+}
+
+// Refer to header for documentation
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
+{
+        if (cfg->n_dev == 0)
+                return 1; // No devices to be driven!
+
+        uint8_t base = cfg->pins[0];
+        uint8_t top = cfg->pins[0];
+
+        for (uint8_t i = 1; i < cfg->n_dev; i++) {
+                if (cfg->pins[i] < base)
+                        base = cfg->pins[i];
+                if (cfg->pins[i] > top)
+                        top = cfg->pins[i];
+        }
+
+        if (top - base >= 8)
+                return 2; // Pins do not lie within 8 consecutive GPIOs!
+
+        bool parallel = cfg->n_dev > 1;
+        int8_t offset = parallel ? ws2812_load(cfg->pio, &_ws2812_parallel_program, _ws2812_parallel_offset) :
+                                   ws2812_load(cfg->pio, &_ws2812_sideset_program, _ws2812_sideset_offset);
+        int sm = pio_claim_unused_sm(cfg->pio, false);
+        int dma = parallel ? -1 : dma_claim_unused_channel(false);
+
+        if (offset < 0 || sm < 0 || (!parallel && dma < 0)) {
+                if (sm >= 0)
+                        pio_sm_unclaim(cfg->pio, sm);
+                if (dma >= 0)
+                        dma_channel_unclaim(dma);
+                return 3; // No PIO program space, state machine or DMA channel left!
+        }
+
+        dev->pio = cfg->pio;
+        dev->sm = sm;
+        dev->dma = dma;
+        dev->pin_msk = 0;
+
+        for (uint8_t i = 0; i < cfg->n_dev; i++) {
+                pio_gpio_init(cfg->pio, cfg->pins[i]);
+                pio_sm_set_consecutive_pindirs(cfg->pio, sm, cfg->pins[i], 1, true);
+                dev->pin_msk |= 1 << (cfg->pins[i] - base);
+        }
+
+        pio_sm_config c = pio_get_default_sm_config();
+        sm_config_set_wrap(&c, offset, offset + 3);
+        sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+        sm_config_set_clkdiv(&c, (float) clock_get_hz(clk_sys) / w_pio_hz);
+
+        if (parallel) {
+                sm_config_set_out_pins(&c, base, top - base + 1);
+                sm_config_set_out_shift(&c, false, true, 32);
+        } else {
+                sm_config_set_sideset(&c, 1, false, false);
+                sm_config_set_sideset_pins(&c, base);
+                sm_config_set_out_shift(&c, false, true, 8);
+
+                dma_channel_config dc = dma_channel_get_default_config(dma);
+                channel_config_set_transfer_data_size(&dc, DMA_SIZE_8);
+                channel_config_set_read_increment(&dc, true);
+                channel_config_set_write_increment(&dc, false);
+                channel_config_set_dreq(&dc, pio_get_dreq(cfg->pio, sm, true));
+                dma_channel_configure(dma, &dc, &cfg->pio->txf[sm], NULL, 0, false);
+        }
+
+        pio_sm_init(cfg->pio, sm, offset, &c);
+        pio_sm_set_enabled(cfg->pio, sm, true);
+
+        dev->buf = cfg->buf;
+        dev->buf_size = cfg->buf_size;
+        dev->rst_time_us = cfg->rst_time_us;
+        dev->prep = false;
+        dev->brightness = 255;
+        dev->lut = NULL;
+        dev->now_us = NULL;
+#ifdef WS2812_STATS
+        dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+        dev->power = NULL;
+        dev->n_pins = cfg->n_dev;
+#endif
+        dev->rst_pending = false;
+
+        _ws2812_get_rgbmap(&dev->rgbmap, cfg->order);
+
+        return 0;
+}
+
+// Refer to header for documentation
+void ws2812_prep_tx(ws2812 *dev)
+{
+        if (dev->prep == false) {
+                _ws2812_finish_rst(dev);
+                dev->prep = true;
+        }
+}
+
+// Refer to header for documentation
+void ws2812_wait_rst(ws2812 *dev)
+{
+        // The reset only begins once the last byte has been shifted out
+        ws2812_flush(dev);
+        busy_wait_us_32(dev->rst_time_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls)
+{
+        size_t n_bytes = n_pxls * sizeof(ws2812_rgb);
+        const uint8_t *src = (const uint8_t *) pxls;
+
+        ws2812_wait_async(dev);
+
+        if (n_pxls == 0)
+                return;
+
+        bool swizzle = dev->rgbmap[0] != 0 || dev->rgbmap[1] != 1 ||
+                       dev->brightness != 255 || dev->lut != NULL;
+
+        if (dev->dma < 0 || (swizzle && dev->buf_size < n_bytes)) {
+                _ws2812_stats_begin(dev);
+                for (size_t i = 0; i < n_pxls; i++) {
+                        ws2812_tx_pxl(dev, &pxls[i]);
+                        _ws2812_power_pxls(dev, &pxls[i], 1);
+                }
+                _ws2812_stats_end(dev, n_bytes, ws2812_pending_us(dev));
+                return;
+        }
+
+        // Map and correct the frame once, rather than per byte as it is being transmitted
+        if (swizzle) {
+                for (size_t i = 0; i < n_bytes; i += sizeof(ws2812_rgb)) {
+                        dev->buf[i]     = _ws2812_correct(dev, src[i + dev->rgbmap[0]]);
+                        dev->buf[i + 1] = _ws2812_correct(dev, src[i + dev->rgbmap[1]]);
+                        dev->buf[i + 2] = _ws2812_correct(dev, src[i + dev->rgbmap[2]]);
+                }
+                src = dev->buf;
+        }
+
+        _ws2812_stats_begin(dev);
+        dma_channel_transfer_from_buffer_now(dev->dma, src, n_bytes);
+        _ws2812_stats_end(dev, n_bytes, n_bytes * w_byte_us);
+
+        // Accounted while the DMA feeds the frame to the state machine
+        _ws2812_power_pxls(dev, pxls, n_pxls);
+}
+
+// Refer to header for documentation
+bool ws2812_tx_done(ws2812 *dev)
+{
+        return dev->dma < 0 || !dma_channel_is_busy(dev->dma);
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+        ws2812_tx_async(dev, leds, n_leds);
+        ws2812_wait_async(dev);
+}
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
+{
+        ws2812_wait_async(dev);
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                ws2812_rgb pxl = gen(i, ctx);
+                ws2812_tx_pxl(dev, &pxl);
+                _ws2812_power_pxls(dev, &pxl, 1);
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), ws2812_pending_us(dev));
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+                       const ws2812_rgb *palette, size_t n_pxls)
+{
+        if (bits_per_index != 1 && bits_per_index != 2 &&
+            bits_per_index != 4 && bits_per_index != 8)
+                return;
+
+        uint8_t shift = 8 - bits_per_index;
+        uint8_t per_byte = 8 / bits_per_index;
+        uint8_t remaining = 0;
+        uint8_t cur = 0;
+
+        ws2812_wait_async(dev);
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                if (remaining == 0) {
+                        cur = *indices++;
+                        remaining = per_byte;
+                }
+
+                const uint8_t *c = (const uint8_t *) &palette[cur >> shift];
+
+                // Palette entries are expected in the color order of the device
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++)
+                        ws2812_tx_byte(dev, c[j]);
+
+                _ws2812_power_pxls(dev, (const ws2812_rgb *) c, 1);
+
+                cur <<= bits_per_index;
+                remaining--;
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), ws2812_pending_us(dev));
+}
+
+// Refer to header for documentation
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+        ws2812_wait_async(dev);
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++)
+                ws2812_tx_pxl(dev, &color);
+
+        _ws2812_power_fill(dev, color, n_pxls);
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), ws2812_pending_us(dev));
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+        for (size_t i = 0; i < n_runs; i++)
+                ws2812_tx_fill(dev, runs[i].color, runs[i].n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+        ws2812_wait_async(dev);
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_bytes; i++)
+                ws2812_tx_byte(dev, bytes[i]);
+
+        _ws2812_power_bytes(dev, bytes, n_bytes);
+        _ws2812_stats_end(dev, n_bytes, ws2812_pending_us(dev));
+}
+
+// Refer to header for documentation
+size_t ws2812_encode(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls, void *buf, size_t buf_size)
+{
+        size_t n_bytes = n_pxls * sizeof(ws2812_rgb);
+
+        // Devices with multiple pins take two words of bit slices per color byte
+        if (dev->dma < 0)
+                n_bytes = WS2812_ENCODED_SIZE(n_pxls);
+
+        if (buf_size < n_bytes)
+                return 0;
+
+        uint8_t *enc = (uint8_t *) buf;
+        uint32_t *words = (uint32_t *) buf;
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                const uint8_t *c = (const uint8_t *) &pxls[i];
+
+                for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++) {
+                        uint8_t b = _ws2812_correct(dev, c[dev->rgbmap[j]]);
+
+                        if (dev->dma >= 0) {
+                                *enc++ = b;
+                                continue;
+                        }
+
+                        for (uint8_t w = 0; w < 2; w++) {
+                                uint32_t slices = 0;
+
+                                for (uint8_t k = 0; k < 4; k++) {
+                                        slices = (slices << 8) | ((b & 0x80) ? dev->pin_msk : 0);
+                                        b <<= 1;
+                                }
+
+                                *words++ = slices;
+                        }
+                }
+        }
+
+        return n_bytes;
+}
+
+// Refer to header for documentation
+void ws2812_tx_encoded(ws2812 *dev, const void *buf, size_t n_bytes)
+{
+        ws2812_wait_async(dev);
+
+        if (n_bytes == 0)
+                return;
+
+        _ws2812_stats_begin(dev);
+
+        if (dev->dma >= 0) {
+                dma_channel_transfer_from_buffer_now(dev->dma, buf, n_bytes);
+                _ws2812_stats_end(dev, n_bytes, n_bytes * w_byte_us);
+                return;
+        }
+
+        const uint32_t *words = (const uint32_t *) buf;
+
+        for (size_t i = 0; i < n_bytes / sizeof(uint32_t); i++)
+                pio_sm_put_blocking(dev->pio, dev->sm, words[i]);
+
+        _ws2812_stats_end(dev, n_bytes / 8, ws2812_pending_us(dev));
+}
+
+// Refer to header for documentation
+void ws2812_tx_parallel(ws2812 *dev, ws2812_rgb *lanes[], size_t n_pxls)
+{
+        // Devices with a single pin run the side-set program, whose only lane is the one of the pin
+        if (dev->dma >= 0) {
+                ws2812_wait_async(dev);
+                _ws2812_stats_begin(dev);
+                for (size_t i = 0; i < n_pxls; i++)
+                        ws2812_tx_pxl(dev, &lanes[0][i]);
+                _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), ws2812_pending_us(dev));
+                _ws2812_power_pxls(dev, lanes[0], n_pxls);
+                return;
+        }
+
+        ws2812_rgb *lp[8];
+
+        // Lanes of unused pins are transmitted as 0
+        for (uint8_t l = 0; l < 8; l++)
+                lp[l] = (dev->pin_msk & (1 << l)) ? lanes[l] : NULL;
+
+        _ws2812_stats_begin(dev);
+
+        for (size_t i = 0; i < n_pxls; i++) {
+                for (uint8_t j = 0; j < sizeof(dev->rgbmap); j++) {
+                        uint8_t v[8];
+
+                        for (uint8_t l = 0; l < 8; l++)
+                                v[l] = lp[l] ? _ws2812_correct(dev, ((uint8_t *) &(lp[l][i]))[dev->rgbmap[j]]) : 0;
+
+                        // Bit slice the MSBs of all lanes, four slices per FIFO word
+                        for (uint8_t w = 0; w < 2; w++) {
+                                uint32_t slices = 0;
+
+                                for (uint8_t b = 0; b < 4; b++) {
+                                        uint8_t s = 0;
+
+                                        for (uint8_t l = 0; l < 8; l++) {
+                                                s |= (v[l] >> 7) << l;
+                                                v[l] <<= 1;
+                                        }
+
+                                        slices = (slices << 8) | s;
+                                }
+
+                                pio_sm_put_blocking(dev->pio, dev->sm, slices);
+                        }
+                }
+        }
+
+        _ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), ws2812_pending_us(dev));
+        _ws2812_power_lanes(dev, lp, 8, n_pxls);
+}
+
+// Refer to header for documentation
+void _ws2812_release_tx(ws2812 *dev)
+{
+        ws2812_flush(dev);
+        dev->prep = false;
+}
+
+// Refer to header for documentation
+void ws2812_close_tx(ws2812 *dev)
+{
+        if (dev->prep == true) {
+                _ws2812_release_tx(dev);
+                _ws2812_begin_rst(dev);
+        }
+}
+
+#endif
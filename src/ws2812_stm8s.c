@@ -35,10 +35,96 @@
 
 #include <ws2812_common.h>
 #include <ws2812_stm8s.h>
+#include <ws2812.h>
+
+// Timing in ns, unless a timing profile has been selected (see ws2812_common.h)
+#ifdef WS2812_T0H_NS
+#define T_ZEROPULSE WS2812_T0H_NS
+#define T_ONEPULSE WS2812_T1H_NS
+#define T_PERIOD WS2812_PERIOD_NS
+#else
+#define T_ZEROPULSE 350
+#define T_ONEPULSE 750
+#define T_PERIOD 1250
+#endif
+
+// Converts a duration in ns into CPU ticks, rounded to the nearest tick
+#define NS_TO_TICKS(ns) (((F_CPU / 1000UL) * (ns) + 500000UL) / 1000000UL)
+
+// Fixed ticks spent by the bit loop of ws2812_tx_frame()
+#define FIXED_ZEROPULSE 3	///< Ticks of the '0' pulse, excluding NOPs
+#define FIXED_ONEPULSE 6	///< Ticks of the '1' pulse, excluding NOPs
+#define FIXED_LOOP 5		///< Ticks from the '1' falling edge to the next rising edge, excluding NOPs
+
+// Insert NOPs to match the timing, if possible
+// W1 - NOPs between the rising edge and the '0' falling edge
+#if NS_TO_TICKS(T_ZEROPULSE) > FIXED_ZEROPULSE
+#define W1_NOPS (NS_TO_TICKS(T_ZEROPULSE) - FIXED_ZEROPULSE)
+#else
+#define W1_NOPS 0
+#endif
+#define ZEROPULSE_TICKS (FIXED_ZEROPULSE + W1_NOPS)
+
+// W2 - NOPs between the '0' falling edge and the '1' falling edge
+#if NS_TO_TICKS(T_ONEPULSE) > FIXED_ONEPULSE + W1_NOPS
+#define W2_NOPS (NS_TO_TICKS(T_ONEPULSE) - FIXED_ONEPULSE - W1_NOPS)
+#else
+#define W2_NOPS 0
+#endif
+#define ONEPULSE_TICKS (FIXED_ONEPULSE + W1_NOPS + W2_NOPS)
+
+// W3 - NOPs to complete the bit
+#if NS_TO_TICKS(T_PERIOD) > ONEPULSE_TICKS + FIXED_LOOP
+#define W3_NOPS (NS_TO_TICKS(T_PERIOD) - ONEPULSE_TICKS - FIXED_LOOP)
+#else
+#define W3_NOPS 0
+#endif
+
+// P1/P2 - NOPs of ws2812_tx_slices(), where each pulse takes 2 fixed ticks
+#define P1_NOPS (ZEROPULSE_TICKS - 2)
+#if ONEPULSE_TICKS > ZEROPULSE_TICKS + 2
+#define P2_NOPS (ONEPULSE_TICKS - ZEROPULSE_TICKS - 2)
+#else
+#define P2_NOPS 0
+#endif
+
+// The only critical timing parameter is the minimum pulse length of the "0"
+// Warn or throw error if this timing can not be met with current F_CPU settings.
+#define ZEROPULSE_NS ((ZEROPULSE_TICKS * 1000000UL) / (F_CPU / 1000UL))
+#ifdef WS2812_T0H_MAX_NS
+#if ZEROPULSE_NS > WS2812_T0H_MAX_NS
+#error "Sorry, the clock speed is too low for the selected timing profile."
+#endif
+#elif ZEROPULSE_NS > 550
+#error "Sorry, the clock speed is too low. Did you set F_CPU correctly?"
+#elif ZEROPULSE_NS > 450
+#warning "The timing is critical and may only work on WS2812B, not on WS2812(S)."
+#endif
+
+// The "1" must stay clear of the sampling point of the WS2812 (~625ns, or the shortest
+// "1" of the timing profile), which guards the fixed ticks above against changes to the inner loop.
+#ifdef WS2812_T1H_MIN_NS
+#define ONEPULSE_MIN_NS WS2812_T1H_MIN_NS
+#else
+#define ONEPULSE_MIN_NS 625
+#endif
+#define ONEPULSE_NS ((ONEPULSE_TICKS * 1000000UL) / (F_CPU / 1000UL))
+#if ONEPULSE_NS < ONEPULSE_MIN_NS
+#error "The pulse length of the \"1\" is too short. Please check the fixed ticks of the inner loop."
+#endif
+
+// Longest low phase the WS2812 are known to tolerate within a frame, before the time spent
+// between two bytes risks being taken for a reset, which bounds the low phase between two
+// bytes of ws2812_tx_slices() (30 ticks)
+#define LOWMAX_NS 5000
+#define SLICES_GAP_NS ((30 * 1000000UL) / (F_CPU / 1000UL))
+#if SLICES_GAP_NS > LOWMAX_NS
+#error "Sorry, the clock speed is too low to drive lanes in parallel. Did you set F_CPU correctly?"
+#endif
 
-// Ensure that CPU clock runs at 16 MHz
-#if F_CPU != 16000000UL
-#error "F_CPU must be 16MHz!"
+// The NOP sequences below hold up to 15 NOPs
+#if W1_NOPS > 15 || W2_NOPS > 15 || W3_NOPS > 15 || P1_NOPS > 15 || P2_NOPS > 15
+#error "Sorry, the clock speed is too high. Did you set F_CPU correctly?"
 #endif
 
 // Helper constants for time critical stuff
@@ -47,11 +133,49 @@
 #define LDW_OVERHEAD 2						///< Number of CPU ticks for the LDW instruction
 
 // GPIO masks to quickly drive the WS2812 data line
+// These are copied from the device struct by _ws2812_load() at the start of every transmission call,
+// as SDCC forces the transmit loops to work on static copies:
+// - The inline assembler only resolves global and static symbols, not struct member offsets
+//   or any other C expression, hence the field offsets would have to be hard coded
+// - The device pointer is passed on the stack or in X depending on the calling convention
+//   (--sdcccall), thus the assembly cannot locate it portably
+// - X and Y are taken by the bit loop, leaving only absolute addressing for anything else
+// The copies are thus a scratch of the running transmission call, rather than a state of a device.
+// Since they are shared by all devices, transmissions must not nest, meaning an interrupt handler
+// served within an interrupt window (see ws2812_set_irq()) must not transmit to any WS2812 device.
 volatile static uint16_t _port_odr_addr;	///< Address of the ODR register
 volatile static uint8_t _mask_hi;		///< Mask for high state
 volatile static uint8_t _mask_lo;		///< Mask for low state
-
-static bool _prep = false;			///< Flag to indicate if the driver is prepared
+volatile static uint8_t _scale;			///< Brightness + 1 (0 for unscaled transmission)
+volatile static uint16_t _lut;			///< Address of the LUT (0 for no lookup)
+
+// Scratch buffer of the pixels currently being transmitted
+volatile static uint8_t _map[4];		///< Offset of the byte transmitted with k bytes left in the pixel at _map[k]
+volatile static uint8_t _len;			///< Bytes per pixel
+volatile static int16_t _step;			///< Distance between two pixels in bytes
+static volatile const uint8_t * volatile _data;	///< Address of the current pixel
+volatile static uint16_t _n;			///< Remaining pixels of the current ws2812_tx_frame() call
+volatile static uint16_t _k;			///< Remaining bytes of the current pixel (low byte only)
+volatile static uint8_t _bits;			///< Remaining bits of the current byte
+volatile static uint8_t _pxl[3];		///< Corrected bytes of a repeated pixel, in the color order of the device
+volatile static uint32_t _acc;			///< Sum of the LUT corrected bytes transmitted (WS2812_POWER only)
+
+// Color order map of transmissions that are already in the color order of the device
+static const uint8_t _raw_map[3] = { 0, 1, 2 };
+
+// Scratch buffer of the lanes currently being transmitted in parallel
+volatile static uint8_t _lanes[3 * 8];		///< Corrected bytes of the current pixel of all lanes (shifted out in place)
+volatile static uint8_t _vlo;			///< Port state with all data pins low
+volatile static uint8_t _vmid;			///< Port state with only the data pins of '1' lanes high
+
+// Interrupt state of the current transmission call
+static bool _irq_en;				///< Flag to indicate if interrupts were enabled by the caller
+static uint8_t _irq_left;			///< Number of LEDs left until the next interrupt window
+static uint8_t _irq_cc;				///< CC register of the caller, whose interrupt level is restored
+volatile static uint8_t _cc;			///< CC register to be loaded by _ws2812_set_level()
+
+// Interrupt levels as encoded by the I1 and I0 bits of the CC register
+#define CC_LEVEL_2 0x00				///< Only interrupts of software priority level 3 are served
 
 // Decrementing coutner for the delay_us function
 volatile static uint16_t _us_loops_remaining;
@@ -60,13 +184,13 @@ volatile static uint16_t _us_loops_remaining;
  * @brief Halts the program for a given ammount of microseconds.
  * 
  * The following function temporarily disables interrupts and pauses the program
- * code for a provided ammount of microseconds (max 255).
+ * code for a provided ammount of microseconds (max 65535 / LOOPS_PER_US, ex. 8191 at 16 MHz).
  * 
  * @param us Number of microseconds to pause for.
  * 
  * @warning This function is blocking, meaning it reserves the CPU from performing any other tasks.
  */
-static void delay_us(uint8_t us)
+static void delay_us(uint16_t us)
 {
 	_us_loops_remaining = (us * LOOPS_PER_US) - LDW_OVERHEAD;
 
@@ -79,11 +203,114 @@ static void delay_us(uint8_t us)
 	__endasm;
 }
 
+/**
+ * @brief Sets the interrupt level of the CPU to the level held by the I1 and I0 bits of cc.
+ * 
+ * Unlike rim, which always drops the CPU to level 0, this restores any interrupt level
+ * (ex. the level of an interrupt handler, or the level saved by _ws2812_irq_begin()).
+ * The remaining bits of the CC register are left untouched.
+ * 
+ * @param cc CC register holding the interrupt level to be set
+ */
+static void _ws2812_set_level(uint8_t cc)
+{
+	_cc = (ITC_GetCPUCC() & ~CPU_CC_I1I0) | (cc & CPU_CC_I1I0);
+
+	__asm
+		push __cc		// Load _cc into CC through the stack
+		pop cc
+	__endasm;
+}
+
+/**
+ * @brief Disables interrupts for a transmission call, until _ws2812_irq_end() is called.
+ * 
+ * The interrupt level of the caller is saved. Interrupts are considered enabled,
+ * unless the caller runs at level 3 (I1 and I0 set).
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ */
+static void _ws2812_irq_begin(ws2812 *dev)
+{
+	_irq_cc = ITC_GetCPUCC();
+	_irq_en = (_irq_cc & CPU_CC_I1I0) != CPU_CC_I1I0;
+	_irq_left = dev->irq_pxls;
+	disableInterrupts();
+}
+
+/**
+ * @brief Returns the number of LEDs to be transmitted before the next interrupt window is due.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param n_pxls Number of LEDs left to be transmitted
+ */
+static size_t _ws2812_irq_span(ws2812 *dev, size_t n_pxls)
+{
+	if ((dev->irq == ws2812_irq_pxls || dev->irq == ws2812_irq_level) && n_pxls > _irq_left)
+		return _irq_left;
+
+	return n_pxls;
+}
+
+/**
+ * @brief Accounts for transmitted LEDs and serves pending interrupts once an interrupt window is due.
+ * 
+ * The window is only opened if interrupts were enabled by the caller of the transmission,
+ * and is recorded as a gap in the stats of the device, if any. Within the window, the CPU
+ * runs at the interrupt level of the caller, or at level 2 under ws2812_irq_level.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param n_pxls Number of LEDs transmitted since the last call (must not exceed the span
+ * 	returned by _ws2812_irq_span())
+ */
+static void _ws2812_irq_window(ws2812 *dev, size_t n_pxls)
+{
+	if (dev->irq != ws2812_irq_pxls && dev->irq != ws2812_irq_level)
+		return;
+
+	_irq_left -= n_pxls;
+
+	if (_irq_left != 0)
+		return;
+
+	_irq_left = dev->irq_pxls;
+
+	if (_irq_en) {
+		_ws2812_stats_pause(dev);
+		_ws2812_set_level(dev->irq == ws2812_irq_level ? CC_LEVEL_2 : _irq_cc);
+		nop();
+		disableInterrupts();
+		_ws2812_stats_resume(dev);
+	}
+}
+
+/**
+ * @brief Restores the interrupt level saved by _ws2812_irq_begin().
+ */
+static void _ws2812_irq_end(void)
+{
+	_ws2812_set_level(_irq_cc);
+}
+
 // Refer to header for documentation
 uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
 {
 	dev->port_baseaddr = cfg->port_baseaddr;
 	dev->rst_time_us = cfg->rst_time_us;
+	dev->prep = false;
+	dev->brightness = 255;
+	dev->lut = NULL;
+	dev->now_us = NULL;
+#ifdef WS2812_STATS
+	dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+	dev->power = NULL;
+	dev->n_pins = cfg->n_dev;
+#endif
+	dev->rst_pending = false;
+	dev->irq = ws2812_irq_pxls;
+	dev->irq_pxls = 1;
 
 	GPIO_TypeDef *port = (GPIO_TypeDef *)dev->port_baseaddr;
 
@@ -105,14 +332,16 @@ uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
 // Refer to header for documentation
 void ws2812_prep_tx(ws2812 *dev)
 {
-	if (_prep == true)
-		return;
+	if (dev->prep == false) {
+		_ws2812_finish_rst(dev);
 
-	_port_odr_addr = dev->port_baseaddr;
-	_mask_hi = dev->maskhi;
-	_mask_lo = dev->masklo;
-	
-	_prep = true;
+		if (dev->irq == ws2812_irq_frame) {
+			dev->irq_cc = ITC_GetCPUCC();
+			disableInterrupts();
+		}
+	}
+
+	dev->prep = true;
 }
 
 // Refer to header for documentation
@@ -123,39 +352,157 @@ void ws2812_wait_rst(ws2812 *dev)
 }
 
 /**
- * @brief Transmitts a 1 bit to the WS2812 device.
+ * @brief Loads the scratch variables of the transmit loops from the device struct.
+ * 
+ * The following function is called once at the start of every transmission call,
+ * such that the transmit loops only need to access the scratch variables.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param map Color order map of the transmitted pixels (offset of the first, second and third byte)
+ */
+static void _ws2812_load(ws2812 *dev, const uint8_t *map)
+{
+	_port_odr_addr = dev->port_baseaddr;
+	_mask_hi = dev->maskhi;
+	_mask_lo = dev->masklo;
+	_scale = dev->brightness + 1;
+	_lut = (uint16_t) dev->lut;
+
+	_map[3] = map[0];
+	_map[2] = map[1];
+	_map[1] = map[2];
+	_len = sizeof(ws2812_rgb);
+	_step = sizeof(ws2812_rgb);
+	_acc = 0;
+}
+
+/**
+ * @brief Loads a color to be transmitted repeatedly into the _pxl scratch buffer.
+ * 
+ * The following function looks up and scales the bytes of the color once, and stores them
+ * in the color order of the device, such that ws2812_tx_frame() merely has to repeat them.
+ * 
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param color Color to be transmitted repeatedly
+ * 
+ * @warning Must be called after _ws2812_load(), as it replaces the color order map,
+ * 	the LUT and the brightness of the transmit loop. As the bytes are scaled already,
+ * 	the sum in _acc must not be accounted.
+ */
+static void _ws2812_load_color(ws2812 *dev, ws2812_rgb color)
+{
+	const uint8_t *pxl = (const uint8_t *) &color;
+
+	_pxl[0] = _ws2812_correct(dev, pxl[dev->rgbmap[0]]);
+	_pxl[1] = _ws2812_correct(dev, pxl[dev->rgbmap[1]]);
+	_pxl[2] = _ws2812_correct(dev, pxl[dev->rgbmap[2]]);
+
+	_map[3] = 0;
+	_map[2] = 1;
+	_map[1] = 2;
+	_lut = 0;
+	_scale = 0;
+	_step = 0;
+	_data = (const uint8_t *) _pxl;
+}
+
+/**
+ * @brief Transmits the pixels referenced by _data to the WS2812 device.
  * 
- * The following function transmits a 1 bit to the WS2812 device.
- * This is done in inline assembly to ensure that the timing is
- * kept up.
+ * The following function transmits _n pixels of _len bytes each, starting at the address
+ * held by _data, to the WS2812 device, where the byte sent with k bytes left in the pixel
+ * is found at the offset _map[k]. After every pixel, _data is advanced by _step bytes,
+ * thus _data references the next pixel once the function returns. This is done in inline
+ * assembly to ensure that the timing is kept up. The LUT corrected bytes are summed in _acc.
  * 
- * To transmitt a 1 bit, the data line is pulled high for 700ns,
- * then pulled low for 600ns, each allowing for a 150ns margin.
+ * The address of the ODR register is loaded into Y and its content into A only
+ * once per call. From there on, A always holds the current state of the port,
+ * thus toggling the data line merely requires to OR/AND A with the pin masks and
+ * store it back into the ODR register. Every byte is held in XH and shifted
+ * out, MSB first, with the next bit being shifted into the carry flag during
+ * the high phase of the '1' pulse, which keeps the '0' pulse short.
  * 
- * Since we are running at 16 MHz, that would approximately be
- * 11 - 12 CPU ticks for the high state and 9 - 10 CPU ticks for the low
- * state. The "correct" ammount has been brute forced through trail and error.
+ * The NOP sequences of every bit are derived from F_CPU at compile time (W1_NOPS, W2_NOPS
+ * and W3_NOPS). At 16 MHz for example, every bit takes 20 CPU ticks (1.25us):
+ * 	- '0': 6 ticks high (375ns), 14 ticks low
+ * 	- '1': 12 ticks high (750ns), 8 ticks low
  * 
- * The instructions bellow toggle the data line and waits approximately
- * the required time for the high and low state as provided by the
- * datasheet.
+ * The fixed counts have been derived from the instruction timings of the STM8 programming
+ * manual (PM0044). Zero bits take one additional low tick due to the untaken branch, and the
+ * fetch, lookup and brightness scaling of the next byte stretches the last low phase of a byte
+ * by 24 ticks (~1.5us) if neither a LUT nor a brightness is set, and by up to 31 ticks (~1.94us)
+ * if both are. Advancing to the next pixel adds another 13 ticks (~0.81us), and summing the
+ * LUT corrected byte for the power limiter (WS2812_POWER only) 8 ticks (12 on a carry into the
+ * upper word), all of which is well within the tolerances of the WS2812.
  * 
  * To prevent timing inconsistencies due to pipelining, the function
  * must not be made inline, as the function call flushes the pipeline.
  * 
- * Due to the 150ns margin, the function can be looped thus thankfully
- * allowing us to abstract the rest in c code.
- * 
  * @warning This function is blocking, meaning it reserves the CPU from performing any other tasks.
+ * @warning Interrupts must be disabled by the caller.
+ * @warning _n and _len must not be 0.
  */
-static void ws2812_tx_bit_1() // DO NOT INLINE TO PREVENT PIPELINING
+static void ws2812_tx_frame() // DO NOT INLINE TO PREVENT PIPELINING
 {
 	__asm
-		ldw x, __port_odr_addr	// Load address of ODR register into X - 2 Cycles
-		ld a, (x)		// Load content of ODR register into A - 1 Cycle
+		pushw y
+		ldw y, __port_odr_addr	// Load address of ODR register into Y - 2 Cycles
+		ld a, (y)		// Load content of ODR register into A - 1 Cycle
+	0000$:
+		mov __k+1, __len	// Bytes of the next pixel - 1 Cycle
+	0001$:
+		push a			// Fetch next byte through the color order map - 9 Cycles
+		ldw x, __k
+		ld a, (__map, x)
+		clrw x
+		ld xl, a
+		addw x, __data
+		ld a, (x)
+		ldw x, __lut		// Look up byte in LUT, if any - 4/8 Cycles
+		jreq 0004$
+		clrw x
+		ld xl, a
+		addw x, __lut
+		ld a, (x)
+	0004$:
+#ifdef WS2812_POWER
+		clrw x			// Accumulate LUT corrected byte for the power limiter - 8/12 Cycles
+		ld xl, a
+		addw x, __acc+2
+		ldw __acc+2, x
+		jrnc 0006$
+		ldw x, __acc
+		incw x
+		ldw __acc, x
+	0006$:
+#endif
+		ld xh, a		// Scale byte by brightness into XH, unless unscaled - 5/8 Cycles
+		ld xl, a
+		ld a, __scale
+		jreq 0003$
+		mul x, a
+	0003$:
+		pop a			// 1 Cycle
+		sllw x			// Shift first bit into carry - 2 Cycles
+		mov __bits, #8		// 8 bits per byte - 1 Cycle
+	0002$:
 		or a, __mask_hi		// Set data line pin high using the pin mask - 1 Cycle
-		ld (x), a		// Apply changes to ODR register - 1 Cycle
-		nop			// Waste cycles until ~700ns have passed (nops are 1 cycle each)
+		ld (y), a		// Apply changes to ODR register (rising edge) - 1 Cycle
+#if (W1_NOPS & 1)
+		nop			// Waste cycles until ~350ns have passed
+#endif
+#if (W1_NOPS & 2)
+		nop
+		nop
+#endif
+#if (W1_NOPS & 4)
+		nop
+		nop
+		nop
+		nop
+#endif
+#if (W1_NOPS & 8)
+		nop
 		nop
 		nop
 		nop
@@ -163,58 +510,334 @@ static void ws2812_tx_bit_1() // DO NOT INLINE TO PREVENT PIPELINING
 		nop
 		nop
 		nop
+#endif
+		jrc 0005$		// Skip early falling edge for '1' bits - 1/2 Cycles
 		and a, __mask_lo	// Set data line pin low using the pin mask - 1 Cycle
-		ld (x), a		// Apply changes to ODR register - 1 Cycle
-		nop			// Waste cycles until ~600ns have passed (nops are 1 cycle each)
+		ld (y), a		// Apply changes to ODR register ('0' falling edge) - 1 Cycle
+	0005$:
+		sllw x			// Shift next bit into carry, which is kept until the next jrc - 2 Cycles
+#if (W2_NOPS & 1)
+		nop			// Waste cycles until ~750ns have passed
+#endif
+#if (W2_NOPS & 2)
+		nop
+		nop
+#endif
+#if (W2_NOPS & 4)
+		nop
+		nop
+		nop
+		nop
+#endif
+#if (W2_NOPS & 8)
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+#endif
+		and a, __mask_lo	// Set data line pin low using the pin mask - 1 Cycle
+		ld (y), a		// Apply changes to ODR register ('1' falling edge) - 1 Cycle
+#if (W3_NOPS & 1)
+		nop			// Waste cycles until ~1250ns have passed
+#endif
+#if (W3_NOPS & 2)
+		nop
+		nop
+#endif
+#if (W3_NOPS & 4)
+		nop
+		nop
+		nop
+		nop
+#endif
+#if (W3_NOPS & 8)
 		nop
 		nop
 		nop
 		nop
 		nop
 		nop
+		nop
+		nop
+#endif
+		dec __bits		// Next bit - 1 Cycle
+		jrne 0002$		// 2 Cycles
+		dec __k+1		// Next byte of the pixel - 1 Cycle
+		jrne 0001$		// 2 Cycles
+		ldw x, __data		// Next pixel - 6 Cycles
+		addw x, __step
+		ldw __data, x
+		ldw x, __n		// 7 Cycles
+		decw x
+		ldw __n, x
+		jrne 0000$
+		popw y
 	__endasm;
 }
 
 /**
- * @brief Transmitts a 1 bit to the WS2812 device.
- * 
- * The following function transmits a 0 bit to the WS2812 device.
- * This is done in inline assembly to ensure that the timing is
- * kept up.
+ * @brief Transmits n_pxls pixels starting at _data, opening the interrupt windows that are due in between.
  * 
- * To transmitt a 0 bit, the data line is pulled high for 350ns,
- * then pulled low for 800ns, each allowing for a 150ns margin.
+ * @param dev @ref ws2812 "WS2812 device struct" of the transmission
+ * @param n_pxls Number of pixels to be transmitted
+ */
+static void ws2812_tx_pxls(ws2812 *dev, size_t n_pxls)
+{
+	while (n_pxls > 0) {
+		size_t span = _ws2812_irq_span(dev, n_pxls);
+
+		_n = span;
+		ws2812_tx_frame();
+		_ws2812_irq_window(dev, span);
+
+		n_pxls -= span;
+	}
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	_data = (const uint8_t *) leds;
+	ws2812_tx_pxls(dev, n_leds);
+
+	_ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_add(dev, _acc);
+}
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
+{
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_pxls; i++) {
+		ws2812_rgb rgb = gen(i, ctx);
+
+		_data = (const uint8_t *) &rgb;
+		_n = 1;
+
+		ws2812_tx_frame();
+		_ws2812_irq_window(dev, 1);
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_add(dev, _acc);
+}
+
+// Refer to header for documentation
+void ws2812_tx_layout(ws2812 *dev, const ws2812_layout *layout, const ws2812_rgb *pxls)
+{
+	uint16_t w = layout->width;
+	const ws2812_rgb *row;
+	bool rev;
+	size_t n_pxls = 0;
+
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	// Rows wired from their last LED are transmitted backwards from their last RGB value
+	for (uint16_t i = 0; (row = _ws2812_layout_row(layout, pxls, i, &rev)) != NULL; i++) {
+		_data = (const uint8_t *) (rev ? row + w - 1 : row);
+		_step = rev ? -(int16_t) sizeof(ws2812_rgb) : (int16_t) sizeof(ws2812_rgb);
+		ws2812_tx_pxls(dev, w);
+		n_pxls += w;
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_add(dev, _acc);
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+		       const ws2812_rgb *palette, size_t n_pxls)
+{
+	if (bits_per_index != 1 && bits_per_index != 2 &&
+	    bits_per_index != 4 && bits_per_index != 8)
+		return;
+
+	uint8_t shift = 8 - bits_per_index;
+	uint8_t per_byte = 8 / bits_per_index;
+	uint8_t remaining = 0;
+	uint8_t cur = 0;
+
+	_ws2812_load(dev, _raw_map);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_pxls; i++) {
+		if (remaining == 0) {
+			cur = *indices++;
+			remaining = per_byte;
+		}
+
+		_data = (const uint8_t *) &palette[cur >> shift];
+		_n = 1;
+
+		cur <<= bits_per_index;
+		remaining--;
+
+		ws2812_tx_frame();
+		_ws2812_irq_window(dev, 1);
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_add(dev, _acc);
+}
+
+// Refer to header for documentation
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	_ws2812_load_color(dev, color);
+	ws2812_tx_pxls(dev, n_pxls);
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_fill(dev, color, n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+	size_t n_pxls = 0;
+
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_runs; i++) {
+		_ws2812_load_color(dev, runs[i].color);
+		ws2812_tx_pxls(dev, runs[i].n_pxls);
+		_ws2812_power_fill(dev, runs[i].color, runs[i].n_pxls);
+		n_pxls += runs[i].n_pxls;
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+	uint8_t tail = n_bytes % sizeof(ws2812_rgb);
+
+	_ws2812_load(dev, _raw_map);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	// Interrupt windows are counted in units of 3 bytes, just as for ws2812_tx()
+	_data = bytes;
+	ws2812_tx_pxls(dev, n_bytes / sizeof(ws2812_rgb));
+
+	// The remaining bytes are transmitted as one shorter pixel
+	if (tail) {
+		_map[tail] = 0;
+		_map[1] = tail - 1;
+		_len = tail;
+		_n = 1;
+
+		ws2812_tx_frame();
+		_ws2812_irq_window(dev, 1);
+	}
+
+	_ws2812_stats_end(dev, n_bytes, 0);
+	_ws2812_irq_end();
+
+	_ws2812_power_add(dev, _acc);
+}
+
+/**
+ * @brief Transmits the pixel held in the _lanes scratch buffer to the WS2812 device in parallel.
  * 
- * Since we are running at 16 MHz, that would approximately be
- * 5 - 6 CPU ticks for the high state and 12 - 13 CPU ticks for the low
- * state. The "correct" ammount has been brute forced through trail and error.
+ * The following function transmits the three bytes of all lanes held in the _lanes scratch buffer
+ * in parallel, where the bytes of lane n are output on pin n of the port. The bytes are expected to
+ * be corrected already and ordered as by _ws2812_correct_lanes(). Before every bit slot, the MSBs
+ * of all lane bytes are bit sliced into A, from which the port state for the time between the '0'
+ * pulse and the '1' pulse is derived. The lane bytes are addressed through Y, which is advanced
+ * to the next byte of all lanes in between two bytes.
  * 
- * The instructions bellow toggle the data line and waits approximately
- * the required time for the high and low state as provided by the
- * datasheet.
+ * The high phases match the ones of ws2812_tx_frame() (P1_NOPS and P2_NOPS), while the low
+ * phase of every bit is stretched by the bit slicing to 25 ticks, and the one between two
+ * bytes to 30 ticks (~1.88us at 16 MHz, see SLICES_GAP_NS).
  * 
  * To prevent timing inconsistencies due to pipelining, the function
  * must not be made inline, as the function call flushes the pipeline.
  * 
- * Due to the 150ns margin, the function can be looped thus thankfully
- * allowing us to abstract the rest in c code.
- * 
  * @warning This function is blocking, meaning it reserves the CPU from performing any other tasks.
+ * @warning Interrupts must be disabled by the caller.
  */
-static void ws2812_tx_bit_0() // DO NOT INLINE TO PREVENT PIPELINING
+static void ws2812_tx_slices() // DO NOT INLINE TO PREVENT PIPELINING
 {
 	__asm
-		ldw x, __port_odr_addr
-		ld a, (x)
+		pushw y
+		ldw x, __port_odr_addr	// Load address of ODR register into X - 2 Cycles
+		ld a, (x)		// Load port state with all data pins low - 3 Cycles
+		and a, __mask_lo
+		ld __vlo, a
+		ldw y, #__lanes		// Load address of the lanes into Y - 2 Cycles
+		mov __k+1, #3		// 3 bytes per pixel - 1 Cycle
+	0001$:
+		mov __bits, #8		// 8 bits per byte - 1 Cycle
+	0000$:
+		sll (7, y)		// Bit slice MSBs of all lanes into A - 16 Cycles
+		rlc a
+		sll (6, y)
+		rlc a
+		sll (5, y)
+		rlc a
+		sll (4, y)
+		rlc a
+		sll (3, y)
+		rlc a
+		sll (2, y)
+		rlc a
+		sll (1, y)
+		rlc a
+		sll (0, y)
+		rlc a
+		and a, __mask_hi	// Derive port state of '1' lanes - 3 Cycles
+		or a, __vlo
+		ld __vmid, a
+		ld a, __vlo		// Set all data line pins high - 2 Cycles
 		or a, __mask_hi
-		ld (x), a
+		ld (x), a		// Apply changes to ODR register (rising edge) - 1 Cycle
+#if (P1_NOPS & 1)
+		nop			// Waste cycles until ~350ns have passed
+#endif
+#if (P1_NOPS & 2)
 		nop
 		nop
-		and a, __mask_lo
-		ld (x), a
+#endif
+#if (P1_NOPS & 4)
+		nop
 		nop
 		nop
 		nop
+#endif
+#if (P1_NOPS & 8)
+		nop
 		nop
 		nop
 		nop
@@ -222,51 +845,84 @@ static void ws2812_tx_bit_0() // DO NOT INLINE TO PREVENT PIPELINING
 		nop
 		nop
 		nop
+#endif
+		ld a, __vmid		// Pull '0' lanes low - 1 Cycle
+		ld (x), a		// Apply changes to ODR register ('0' falling edge) - 1 Cycle
+#if (P2_NOPS & 1)
+		nop			// Waste cycles until ~750ns have passed
+#endif
+#if (P2_NOPS & 2)
+		nop
+		nop
+#endif
+#if (P2_NOPS & 4)
+		nop
+		nop
+		nop
+		nop
+#endif
+#if (P2_NOPS & 8)
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+		nop
+#endif
+		ld a, __vlo		// Pull '1' lanes low - 1 Cycle
+		ld (x), a		// Apply changes to ODR register ('1' falling edge) - 1 Cycle
+		dec __bits		// Next bit - 1 Cycle
+		jrne 0000$		// 2 Cycles
+		addw y, #8		// Next byte of all lanes - 2 Cycles
+		dec __k+1		// Next byte of the pixel - 1 Cycle
+		jrne 0001$		// 2 Cycles
+		popw y
 	__endasm;
 }
 
-/**
- * @brief Transmits a byte of data to the WS2812 device.
- * 
- * The following function transmits a single byte of data to the WS2812 device.
- * This is done by looping through the bits of the byte and calling the
- * appropriate ws2812_tx_bit_* function.
- * 
- * @param byte The byte to be transmitted.
- */
-static inline void ws2812_tx_byte(uint8_t byte)
+// Refer to header for documentation
+void ws2812_tx_parallel(ws2812 *dev, ws2812_rgb *lanes[], size_t n_pxls)
 {
-	for (uint8_t i = 0; i < 8; i++)
-	{
-		disableInterrupts();
-		if (byte & 0b10000000) // Tests every bit in the byte
-			ws2812_tx_bit_1();
-		else
-			ws2812_tx_bit_0();
-		enableInterrupts();
-		byte <<= 1;
+	ws2812_rgb *lp[8];
+
+	// Lanes of unused pins are transmitted as 0
+	for (uint8_t l = 0; l < 8; l++)
+		lp[l] = (dev->maskhi & (1 << l)) ? lanes[l] : NULL;
+
+	_ws2812_load(dev, dev->rgbmap);
+	_ws2812_irq_begin(dev);
+	_ws2812_stats_begin(dev);
+
+	// Every pixel is corrected ahead, leaving no work between its bytes
+	for (size_t i = 0; i < n_pxls; i++) {
+		_ws2812_correct_lanes(dev, lp, 8, (uint8_t *) _lanes);
+		ws2812_tx_slices();
+		_ws2812_irq_window(dev, 1);
 	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), 0);
+	_ws2812_irq_end();
 }
 
 // Refer to header for documentation
-void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+void _ws2812_release_tx(ws2812 *dev)
 {
-        for (size_t i = 0; i < n_leds; i++) {
-                for (uint8_t j = 0; j < sizeof(dev->rgbmap); j++) {
-                        uint8_t *pxl = (uint8_t *) &(leds[i]);
-                        ws2812_tx_byte(pxl[dev->rgbmap[j]]);
-                }
-        }
+	if (dev->prep && dev->irq == ws2812_irq_frame)
+		_ws2812_set_level(dev->irq_cc);
+
+	dev->prep = false;
 }
 
 // Refer to header for documentation
 void ws2812_close_tx(ws2812 *dev)
 {
-	if (_prep == false)
+	if (dev->prep == false)
 		return;
 
-	_prep = false;
-        ws2812_wait_rst(dev);
+	_ws2812_release_tx(dev);
+	_ws2812_begin_rst(dev);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2026  Patrick Pedersen
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812_stm8s_spi.c
+ * @author Patrick Pedersen
+ * @date 2026-10-14
+ *
+ * @brief Driver code for STM8S chips using the SPI peripheral.
+ *
+ * The following file holds the Tiny-WS2812 library code to drive
+ * WS2812 devices on STM8S chips through the SPI peripheral.
+ *
+ * Rather than generating every bit through cycle counted assembly, every WS2812 bit
+ * is encoded into four SPI bits (`1000` for a '0' and `1100` for a '1'), which are
+ * shifted out on the MOSI pin at 2 MHz. The waveform timing is thus driven by the
+ * SPI clock, and every SPI byte holds two complete WS2812 bits, ending low.
+ * Refilling the transmit buffer late merely stretches a low phase, hence interrupts
+ * never have to be disabled.
+ */
+
+#ifdef WS2812_TARGET_PLATFORM_STM8S_SPI
+
+#include <stm8s.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <ws2812.h>
+
+// Derive a 2 MHz SPI clock (500ns per SPI bit) from the CPU clock
+#if F_CPU == 16000000UL
+#define SPI_PRESCALER SPI_BAUDRATEPRESCALER_8
+#elif F_CPU == 8000000UL
+#define SPI_PRESCALER SPI_BAUDRATEPRESCALER_4
+#elif F_CPU == 4000000UL
+#define SPI_PRESCALER SPI_BAUDRATEPRESCALER_2
+#else
+#error "F_CPU must be 4, 8 or 16MHz!"
+#endif
+
+// Helper constants for time critical stuff
+#define TICKS_PER_LOOP 2					///< Number of CPU ticks per loop in delay_us function
+#define LOOPS_PER_US (F_CPU / TICKS_PER_LOOP / 1000000UL)	///< Number for loops required for 1 us to pass
+#define LDW_OVERHEAD 2						///< Number of CPU ticks for the LDW instruction
+#define US_PER_BYTE 16						///< Time for a color byte to be shifted out (32 SPI bits)
+#define PENDING_US 4						///< Time for the byte held in the transmit buffer to be shifted out
+
+// SPI encoding of every bit pair, where each bit b is encoded as `1b00`
+static const uint8_t _pair_enc[4] = { 0x88, 0x8C, 0xC8, 0xCC };
+
+// State of the background transmission
+static ws2812 * volatile _async_dev;		///< Device of the background transmission (NULL if idle)
+static const uint8_t *_async_pxl;		///< Pixel currently being transmitted
+static size_t _async_n;				///< Remaining pixels, including the current one
+static uint8_t _async_byte;			///< Index of the next color byte of the current pixel
+static uint8_t _async_pairs;			///< Remaining bit pairs of the current color byte
+static uint8_t _async_c;			///< Current color byte, shifted out MSB first
+static const uint8_t *_async_enc;		///< Next byte of an encoded bitstream (NULL if RGB values are transmitted)
+static size_t _async_enc_n;			///< Remaining bytes of the encoded bitstream
+
+// Decrementing coutner for the delay_us function
+volatile static uint16_t _us_loops_remaining;
+
+/**
+ * @brief Halts the program for a given ammount of microseconds.
+ *
+ * The following function pauses the program code for a provided
+ * ammount of microseconds (max 65535 / LOOPS_PER_US, ex. 8191 at 16 MHz).
+ *
+ * @param us Number of microseconds to pause for.
+ *
+ * @warning This function is blocking, meaning it reserves the CPU from performing any other tasks.
+ */
+static void delay_us(uint16_t us)
+{
+	_us_loops_remaining = (us * LOOPS_PER_US) - LDW_OVERHEAD;
+
+	__asm
+		ldw x, __us_loops_remaining	// 2 Cycles
+	0000$:
+		decw x				// 1 Cycle
+		jrne 0000$			// 1-2 Cycles
+
+	__endasm;
+}
+
+/**
+ * @brief Waits for the background transmission, if any, to hand over its last byte.
+ */
+static void ws2812_wait_async()
+{
+	while (_async_dev != NULL);
+}
+
+/**
+ * @brief Waits for all bytes, including the ones of a background transmission, to be shifted out.
+ */
+static void ws2812_flush()
+{
+	ws2812_wait_async();
+	while (!(SPI->SR & SPI_SR_TXE));
+	while (SPI->SR & SPI_SR_BSY);
+}
+
+/**
+ * @brief Writes a byte into the SPI transmit buffer once it is empty.
+ */
+static inline void ws2812_put(uint8_t b)
+{
+	while (!(SPI->SR & SPI_SR_TXE));
+	SPI->DR = b;
+}
+
+/**
+ * @brief Encodes and transmits a single color byte.
+ *
+ * The following function corrects the color byte by the LUT and brightness
+ * of the device, and transmits its 32 bit SPI encoding as four bytes.
+ */
+static void ws2812_tx_byte(ws2812 *dev, uint8_t c)
+{
+	c = _ws2812_correct(dev, c);
+
+	ws2812_put(_pair_enc[c >> 6]);
+	ws2812_put(_pair_enc[(c >> 4) & 0x03]);
+	ws2812_put(_pair_enc[(c >> 2) & 0x03]);
+	ws2812_put(_pair_enc[c & 0x03]);
+}
+
+/**
+ * @brief Transmits a single RGB value in the color order of the device.
+ */
+static void ws2812_tx_pxl(ws2812 *dev, const ws2812_rgb *pxl)
+{
+	const uint8_t *c = (const uint8_t *) pxl;
+
+	ws2812_tx_byte(dev, c[dev->rgbmap[0]]);
+	ws2812_tx_byte(dev, c[dev->rgbmap[1]]);
+	ws2812_tx_byte(dev, c[dev->rgbmap[2]]);
+}
+
+// Refer to header for documentation
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
+{
+	dev->rst_time_us = cfg->rst_time_us;
+	dev->prep = false;
+	dev->brightness = 255;
+	dev->lut = NULL;
+	dev->now_us = NULL;
+#ifdef WS2812_STATS
+	dev->stats = NULL;
+#endif
+#ifdef WS2812_POWER
+	dev->power = NULL;
+	dev->n_pins = 1;
+#endif
+	dev->rst_pending = false;
+
+	GPIO_Init(GPIOC, GPIO_PIN_6, GPIO_MODE_OUT_PP_LOW_FAST); // MOSI
+
+	CLK_PeripheralClockConfig(CLK_PERIPHERAL_SPI, ENABLE);
+	SPI_Init(SPI_FIRSTBIT_MSB, SPI_PRESCALER, SPI_MODE_MASTER, SPI_CLOCKPOLARITY_LOW,
+		 SPI_CLOCKPHASE_1EDGE, SPI_DATADIRECTION_1LINE_TX, SPI_NSS_SOFT, 0x07);
+	SPI_Cmd(ENABLE);
+
+	_ws2812_get_rgbmap(&dev->rgbmap, cfg->order);
+
+	return 0;
+}
+
+// Refer to header for documentation
+void ws2812_prep_tx(ws2812 *dev)
+{
+	if (dev->prep == false)
+		_ws2812_finish_rst(dev);
+
+	dev->prep = true;
+}
+
+// Refer to header for documentation
+void ws2812_wait_rst(ws2812 *dev)
+{
+	// The reset only begins once the last byte has been shifted out
+	ws2812_flush();
+
+	if (dev->rst_time_us)
+		delay_us(dev->rst_time_us);
+}
+
+// Refer to header for documentation
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n_leds)
+{
+	ws2812_wait_async();
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_leds; i++) {
+		ws2812_tx_pxl(dev, &leds[i]);
+		_ws2812_power_pxls(dev, &leds[i], 1);
+	}
+
+	_ws2812_stats_end(dev, n_leds * sizeof(ws2812_rgb), PENDING_US);
+}
+
+// Refer to header for documentation
+void ws2812_tx_gen(ws2812 *dev, ws2812_rgb (*gen)(size_t idx, void *ctx), void *ctx, size_t n_pxls)
+{
+	ws2812_wait_async();
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_pxls; i++) {
+		ws2812_rgb pxl = gen(i, ctx);
+		ws2812_tx_pxl(dev, &pxl);
+		_ws2812_power_pxls(dev, &pxl, 1);
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), PENDING_US);
+}
+
+// Refer to header for documentation
+void ws2812_tx_indexed(ws2812 *dev, const uint8_t *indices, uint8_t bits_per_index,
+		       const ws2812_rgb *palette, size_t n_pxls)
+{
+	if (bits_per_index != 1 && bits_per_index != 2 &&
+	    bits_per_index != 4 && bits_per_index != 8)
+		return;
+
+	uint8_t shift = 8 - bits_per_index;
+	uint8_t per_byte = 8 / bits_per_index;
+	uint8_t remaining = 0;
+	uint8_t cur = 0;
+
+	ws2812_wait_async();
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_pxls; i++) {
+		if (remaining == 0) {
+			cur = *indices++;
+			remaining = per_byte;
+		}
+
+		const uint8_t *c = (const uint8_t *) &palette[cur >> shift];
+
+		// Palette entries are expected in the color order of the device
+		for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++)
+			ws2812_tx_byte(dev, c[j]);
+
+		_ws2812_power_pxls(dev, (const ws2812_rgb *) c, 1);
+
+		cur <<= bits_per_index;
+		remaining--;
+	}
+
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), PENDING_US);
+}
+
+// Refer to header for documentation
+void ws2812_tx_fill(ws2812 *dev, ws2812_rgb color, size_t n_pxls)
+{
+	ws2812_wait_async();
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_pxls; i++)
+		ws2812_tx_pxl(dev, &color);
+
+	_ws2812_power_fill(dev, color, n_pxls);
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), PENDING_US);
+}
+
+// Refer to header for documentation
+void ws2812_tx_rle(ws2812 *dev, const ws2812_run *runs, size_t n_runs)
+{
+	for (size_t i = 0; i < n_runs; i++)
+		ws2812_tx_fill(dev, runs[i].color, runs[i].n_pxls);
+}
+
+// Refer to header for documentation
+void ws2812_tx_raw(ws2812 *dev, const uint8_t *bytes, size_t n_bytes)
+{
+	ws2812_wait_async();
+	_ws2812_stats_begin(dev);
+
+	for (size_t i = 0; i < n_bytes; i++)
+		ws2812_tx_byte(dev, bytes[i]);
+
+	_ws2812_power_bytes(dev, bytes, n_bytes);
+	_ws2812_stats_end(dev, n_bytes, PENDING_US);
+}
+
+// Refer to header for documentation
+void ws2812_tx_async(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls)
+{
+	ws2812_wait_async();
+
+	if (n_pxls == 0)
+		return;
+
+	_ws2812_stats_begin(dev);
+	_ws2812_stats_end(dev, n_pxls * sizeof(ws2812_rgb), n_pxls * sizeof(ws2812_rgb) * US_PER_BYTE);
+
+	_async_pxl = (const uint8_t *) pxls;
+	_async_n = n_pxls;
+	_async_byte = 0;
+	_async_pairs = 0;
+	_async_dev = dev;
+
+	SPI->ICR |= SPI_ICR_TXEI; // The transmit buffer is empty, hence the ISR fires right away
+
+	// Accounted while the ISR transmits the frame
+	_ws2812_power_pxls(dev, pxls, n_pxls);
+}
+
+// Refer to header for documentation
+size_t ws2812_encode(ws2812 *dev, const ws2812_rgb *pxls, size_t n_pxls, void *buf, size_t buf_size)
+{
+	size_t n_bytes = WS2812_ENCODED_SIZE(n_pxls);
+	uint8_t *enc = (uint8_t *) buf;
+
+	if (buf_size < n_bytes)
+		return 0;
+
+	for (size_t i = 0; i < n_pxls; i++) {
+		const uint8_t *c = (const uint8_t *) &pxls[i];
+
+		for (uint8_t j = 0; j < sizeof(ws2812_rgb); j++) {
+			uint8_t b = _ws2812_correct(dev, c[dev->rgbmap[j]]);
+
+			*enc++ = _pair_enc[b >> 6];
+			*enc++ = _pair_enc[(b >> 4) & 0x03];
+			*enc++ = _pair_enc[(b >> 2) & 0x03];
+			*enc++ = _pair_enc[b & 0x03];
+		}
+	}
+
+	return n_bytes;
+}
+
+// Refer to header for documentation
+void ws2812_tx_encoded(ws2812 *dev, const void *buf, size_t n_bytes)
+{
+	ws2812_wait_async();
+
+	if (n_bytes == 0)
+		return;
+
+	_ws2812_stats_begin(dev);
+	_ws2812_stats_end(dev, n_bytes / 4, n_bytes / 4 * US_PER_BYTE);
+
+	_async_enc = (const uint8_t *) buf;
+	_async_enc_n = n_bytes;
+	_async_dev = dev;
+
+	SPI->ICR |= SPI_ICR_TXEI; // The transmit buffer is empty, hence the ISR fires right away
+}
+
+// Refer to header for documentation
+bool ws2812_tx_done(ws2812 *dev)
+{
+	return _async_dev != dev;
+}
+
+// Refer to header for documentation
+void ws2812_spi_isr(void)
+{
+	if (_async_dev == NULL || !(SPI->SR & SPI_SR_TXE))
+		return;
+
+	// Encoded bitstreams are handed to the SPI peripheral as they are
+	if (_async_enc != NULL) {
+		if (_async_enc_n == 0) {
+			SPI->ICR &= ~SPI_ICR_TXEI;
+			_async_enc = NULL;
+			_async_dev = NULL;
+			return;
+		}
+
+		SPI->DR = *_async_enc++;
+		_async_enc_n--;
+		return;
+	}
+
+	if (_async_pairs == 0) {
+		if (_async_byte == sizeof(ws2812_rgb)) {
+			_async_byte = 0;
+			_async_pxl += sizeof(ws2812_rgb);
+
+			if (--_async_n == 0) {
+				SPI->ICR &= ~SPI_ICR_TXEI;
+				_async_dev = NULL;
+				return;
+			}
+		}
+
+		_async_c = _ws2812_correct(_async_dev, _async_pxl[_async_dev->rgbmap[_async_byte++]]);
+		_async_pairs = 4;
+	}
+
+	SPI->DR = _pair_enc[_async_c >> 6];
+	_async_c <<= 2;
+	_async_pairs--;
+}
+
+// Refer to header for documentation
+void _ws2812_release_tx(ws2812 *dev)
+{
+	ws2812_flush();
+	dev->prep = false;
+}
+
+// Refer to header for documentation
+void ws2812_close_tx(ws2812 *dev)
+{
+	if (dev->prep == false)
+		return;
+
+	_ws2812_release_tx(dev);
+	_ws2812_begin_rst(dev);
+}
+
+#endif
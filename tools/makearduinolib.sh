@@ -4,6 +4,9 @@
 declare -a PLATFORMS=(
         "AVR"
         "ARDUINO_AVR"
+        "AVR_USART"
+        "ESP32"
+        "RP2040"
 )
 
 # cd into project root